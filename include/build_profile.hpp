@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+// Seconds between the progress reports of a build
+#define BUILD_PROGRESS_INTERVAL 10
+
+// Phases of graph construction that are timed separately
+enum BuildPhase {
+    PHASE_MEDOID,           // Start node (medoid) selection
+    PHASE_GREEDY_SEARCH,    // Search for the candidate neighbors of an inserted point
+    PHASE_ROBUST_PRUNE,     // Prune of the candidates of an inserted point
+    PHASE_BACK_EDGES,       // Reverse edges to an inserted point (and the prunes of its neighbors)
+    PHASE_STITCHING,        // Union of the per-filter graphs (StitchedVamana)
+    PHASE_FINAL_PRUNE,      // Prune of every vertex of the stitched graph
+    NUM_BUILD_PHASES
+};
+
+// Time spent in every phase of graph construction, and progress of the points inserted so far
+// Every thread adds its times to its own counters, so timing needs no locking. Times are summed over threads
+class BuildProfile {
+public:
+    BuildProfile();
+
+    // Start reporting progress, every BUILD_PROGRESS_INTERVAL seconds, of a build that will insert 'total' points
+    void begin(long total);
+
+    // Add 'seconds' to 'phase' for the current thread
+    void add(BuildPhase phase, double seconds);
+
+    // Count an inserted point, printing a progress report if the interval has passed
+    void point_done();
+
+    // Total seconds of 'phase' over all threads
+    double phase_seconds(BuildPhase phase) const;
+
+    // Print the time of every phase and a machine-readable (JSON) summary line for a build that took 'wall_seconds'
+    void print(double wall_seconds) const;
+
+private:
+    std::vector<std::array<double, NUM_BUILD_PHASES>> seconds;  // Per thread
+    std::atomic<long> points{0};
+    long total = 0;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<long> next_report{0};   // Milliseconds since 'start' of the next progress report
+};
+
+// Profile of the graph builders
+extern BuildProfile build_profile;
+
+// Adds the time from its creation until the end of its scope to a phase of build_profile
+class PhaseTimer {
+public:
+    explicit PhaseTimer(BuildPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+    ~PhaseTimer() {
+        build_profile.add(phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    BuildPhase phase;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <sys/types.h>
+
+// Bytes of every read of ChunkedReader. A multiple of the page size, so that reads are aligned
+#define READER_CHUNK_SIZE (4 << 20)
+
+// An io_uring instance set up with the raw system calls: reads are queued to its submission ring, submitted together
+// with one system call and reaped from its completion ring. A ring must only be used by one thread at a time
+class IoRing {
+public:
+    IoRing() = default;
+    ~IoRing();
+
+    IoRing(const IoRing&) = delete;
+    IoRing& operator=(const IoRing&) = delete;
+
+    // Set up a ring of at least 'entries' entries. Returns false if the kernel does not allow it
+    bool setup(unsigned entries);
+
+    // Unmap the rings and close the instance
+    void close();
+
+    // True if the ring is set up
+    bool available() const { return ring_fd != -1; }
+
+    // Number of reads that can be queued before they are submitted
+    unsigned entries() const { return num_entries; }
+
+    // Queue a read of 'bytes' bytes of 'fd' at 'offset' to 'buffer'. 'tag' is returned with its completion
+    void queue_read(int fd, void *buffer, size_t bytes, off_t offset, uint64_t tag);
+
+    // Submit the queued reads and wait until 'wait' reads (of these or earlier submissions) have completed
+    // Returns false if the kernel refused them
+    bool submit(unsigned wait = 0);
+
+    // Wait for the next completion. Returns the tag of its read and stores its result (bytes read or -errno) to 'result'
+    uint64_t complete(int& result);
+
+private:
+    int ring_fd = -1;
+    unsigned num_entries = 0;
+    unsigned queued = 0;            // Reads queued since the last submission
+    void *sq_ring = nullptr, *cq_ring = nullptr, *sqes = nullptr;
+    size_t sq_ring_size = 0, cq_ring_size = 0, sqes_size = 0;
+    unsigned *sq_tail, *sq_mask, *sq_array, *cq_head, *cq_tail, *cq_mask;
+    void *cqes;
+};
+
+// Reads a file sequentially in large chunks, into two buffers: while the caller decodes one, the read of the next chunk
+// is in flight. Reads are issued through io_uring when the kernel allows it, else with pread() in a background thread
+class ChunkedReader {
+public:
+    // Open 'file_name'. 'chunk_size' must be a multiple of 4096. io_uring is not tried if 'use_io_uring' is false
+    explicit ChunkedReader(const std::string& file_name, size_t chunk_size = READER_CHUNK_SIZE, bool use_io_uring = true);
+    ~ChunkedReader();
+
+    ChunkedReader(const ChunkedReader&) = delete;
+    ChunkedReader& operator=(const ChunkedReader&) = delete;
+
+    // Copy the next 'bytes' bytes of the file to 'data'. Returns false if the file ends first
+    bool read(void *data, size_t bytes);
+
+    // True if the reads go through io_uring
+    bool uses_io_uring() const { return ring.available(); }
+
+private:
+    int fd;
+    off_t file_size;
+    off_t next_offset = 0;          // Offset of the next chunk to read
+    size_t chunk_size;
+
+    char *buffers[2];               // Page aligned buffers of 'chunk_size' bytes
+    int current = 0;                // Buffer that is decoded
+    size_t position = 0, length = 0;// Decoded and read bytes of the current buffer
+    bool in_flight = false;         // A read of the other buffer is in flight
+    size_t requested = 0;           // Bytes of the read in flight
+
+    // Ring of the reads. It is not available when pread() is used
+    IoRing ring;
+    bool ring_verified = false;     // A read through io_uring has completed (the kernel supports IORING_OP_READ)
+
+    std::future<ssize_t> pending;   // Read in flight of the pread() fallback
+
+    // Start reading the next chunk into the other buffer
+    void submit();
+
+    // Wait for the read in flight and make its buffer the current one
+    void wait();
+};
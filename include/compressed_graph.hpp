@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "directed_graph.hpp"
+#include "huge_pages.hpp"
+
+// Read-only copy of a DirectedGraph with compressed neighbor lists, for searching large indexes in less memory
+// Every neighbor list is sorted and delta encoded, and the deltas are stored in the StreamVByte format: a control byte
+// holds the byte lengths (1 to 4) of 4 deltas, and the bytes of the deltas follow all the control bytes of the list.
+// Lists are decoded on the fly, 4 deltas per shuffle when SSSE3 is available
+class CompressedGraph {
+public:
+    // Compress the neighbor lists of 'graph'. Its deleted markers are copied as well
+    explicit CompressedGraph(const DirectedGraph& graph);
+
+    // Returns the neighbors of vertex 'v' in ascending order. The list is decoded into a buffer of the calling thread,
+    // so it is only valid until the thread's next call
+    const std::vector<Vertex>& get_neighbors(Vertex v) const;
+
+    // Size accessor
+    int get_size() const { return size; }
+
+    // Returns true if vertex 'v' was deleted in the compressed graph
+    bool is_deleted(Vertex v) const { return deleted[v]; }
+
+    // Number of edges
+    size_t edges() const { return num_edges; }
+
+    // Bytes of the compressed lists and their offsets
+    size_t memory() const;
+
+    // Bytes of the same lists as 32-bit neighbor ids with 64-bit offsets, for comparison
+    size_t flat_memory() const { return num_edges * sizeof(int32_t) + (size + 1) * sizeof(uint64_t); }
+
+private:
+    int size;
+    size_t num_edges = 0;
+    // Arrays read by every expansion are on huge pages if they are enabled (see set_huge_pages())
+    std::vector<uint64_t, HugePageAllocator<uint64_t>> offsets; // Start of the list of every vertex in 'data', and the end of the last one
+    std::vector<uint16_t, HugePageAllocator<uint16_t>> degrees; // Degrees are at most R
+    std::vector<uint8_t, HugePageAllocator<uint8_t>> data;      // Padded, so that decoding may read 16 bytes past the last list
+    std::vector<bool> deleted;
+};
+
+// Encode 'count' values in the StreamVByte format to 'out'. Returns the number of bytes written, at most
+// (count + 3) / 4 + 4 * count
+size_t stream_vbyte_encode(const uint32_t *values, size_t count, uint8_t *out);
+
+// Decode 'count' values from 'in' to 'out'. 'in' must be readable for 16 bytes past the encoded values
+void stream_vbyte_decode(const uint8_t *in, size_t count, uint32_t *out);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_set>    // std::unordered_set etc.
+#include <vector>           // std::vector
 
 // Representation of a Vertex is an index (int)
 typedef int Vertex;
@@ -26,12 +27,34 @@ public:
     // Stitch a graph created with the Pf dataset to the existing graph. This is done by unionizing their edge sets
     void stitch(DirectedGraph *g, int *Pf);
 
+    // Grow the graph to 'num_of_vertices' vertices. The new vertices have no edges and existing edges are kept
+    void resize(int num_of_vertices);
+
     // Returns a reference to an unordered-set that contains the neighbors of vertex 'v'. 'const' is used to prevent data modification
     const std::unordered_set<Vertex>& get_neighbors(Vertex v) const;
 
     // Size accessor
     int get_size() const { return neighbors_size; }
 
+    // Mark vertex 'v' as deleted (tombstone). Its edges are kept, so that it can still be traversed until consolidation
+    void mark_deleted(Vertex v);
+
+    // Returns true if vertex 'v' is tombstoned or freed. Deleted vertices must never be returned as results
+    bool is_deleted(Vertex v) const { return deleted[v]; }
+
+    // Tombstoned vertices that have not been consolidated (freed) yet
+    const std::vector<Vertex>& get_tombstones() const { return tombstones; }
+
+    // Vertices that have been freed and can be reused for new points
+    const std::vector<Vertex>& get_free_vertices() const { return free_vertices; }
+
+    // Remove all out-edges of the tombstoned vertices and make their slots available for reuse
+    // In-edges must have already been removed by the caller (see filtered_consolidate())
+    void free_tombstones();
+
+    // Returns a freed vertex which is no longer deleted, so it can be used for a new point. Returns -1 if there is none
+    Vertex reuse_vertex();
+
 private:
     // Array of sets. Each set contains the neighbors of the vector in the corresponding array index
     // Example: Neighbors of vector with index 4 are in neighbors[4] unordered set
@@ -40,4 +63,11 @@ private:
     
     // 'neighbors' array size (num of rows/vertices)
     int neighbors_size;
+
+    // Array of deleted markers, one for each vertex
+    bool *deleted;
+
+    // Deleted vertices waiting for consolidation and freed vertices waiting for reuse
+    std::vector<Vertex> tombstones;
+    std::vector<Vertex> free_vertices;
 };
\ No newline at end of file
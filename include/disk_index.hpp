@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "directed_graph.hpp"
+#include "huge_pages.hpp"
+#include "label_set.hpp"
+#include "vectors.hpp"
+
+// Size of the blocks of the disk index. Every node lies within as few sectors as possible, so it is read at once
+#define DISK_SECTOR 4096
+// Default number of nodes whose sectors are read together in every step of the disk search
+#define DISK_BEAM_WIDTH 4
+// Entries of the io_uring of every searching thread. Wider beams are read in batches of this many nodes
+#define DISK_RING_ENTRIES 64
+
+// Writes a graph and its base vectors as a disk index: a header sector, then the nodes, each with its full precision
+// vector and its neighbors (padded to the max degree) in the same sector(s), then the data kept in memory while
+// searching: 8-bit scalar quantized codes of the vectors, labels, start nodes and deleted markers
+void write_disk_index(const DirectedGraph& graph, const Vectors& vectors, std::vector<int> *M, const std::string& file_name);
+
+// Reads and searches a disk index. Only the compact codes, labels and start nodes are kept in memory; the full precision
+// vectors and the neighbor lists are read from the file when a node is expanded
+// Nodes are read with O_DIRECT, so they do not fill the page cache, unless the file system does not support it. The
+// sectors of a beam are read together through an io_uring of the searching thread, or one after another with pread()
+// if the kernel does not allow it or 'use_io_uring' is false
+class DiskIndex {
+public:
+    explicit DiskIndex(const std::string& file_name, bool use_io_uring = true);
+    ~DiskIndex();
+
+    DiskIndex(const DiskIndex&) = delete;
+    DiskIndex& operator=(const DiskIndex&) = delete;
+
+    int size() const { return points; }
+    int dimension() const { return dims; }
+
+    // Returns the label of a filter value. Value -1 maps to NO_LABEL and unknown values to UNKNOWN_LABEL
+    Label find_label(float value) const;
+
+    // Returns the k nearest neighbors of 'query' that share a label with 'filter' (any point if it is empty)
+    // The L candidates are ranked by their codes, and every step reads the nodes of the 'beam_width' best unexpanded
+    // ones. The expanded nodes are ranked again by their full precision distance. 'reads' counts the read sectors
+    std::vector<int> search(const float *query, const LabelSet& filter, int k, int L, int beam_width, long *reads = nullptr) const;
+
+    // Bytes kept in memory
+    size_t memory() const;
+    // True if the nodes bypass the page cache
+    bool reads_direct() const { return direct; }
+    // Bytes of the nodes, which are read from the file
+    size_t node_bytes() const { return (size_t)points * node_size; }
+
+private:
+    int fd;
+    bool direct;                    // 'fd' was opened with O_DIRECT
+    bool use_io_uring;
+    int points, dims, max_degree;
+    size_t node_size;               // Bytes of a node: vector, degree and neighbors
+    int nodes_per_sector;           // 0 if a node takes more than one sector
+    int sectors_per_node;
+
+    std::vector<uint8_t, HugePageAllocator<uint8_t>> codes; // 'dims' codes per point, on huge pages if they are enabled
+    std::vector<float> minimum, step;   // Value of code c in dimension d is minimum[d] + c * step[d]
+    std::vector<LabelSet> filters;
+    std::vector<int> start_nodes;   // Start node of every label (-1 for labels without points)
+    std::vector<bool> deleted;
+    std::unordered_map<float, Label> label_ids;
+
+    // Squared distance between 'query' and the decoded code of 'point'
+    float code_distance(const float *query, int point) const;
+
+    // Offset of the first sector of the node of 'point'
+    off_t node_offset(int point) const;
+
+    // Read the sectors of the nodes of 'beam' to 'buffer' (aligned to DISK_SECTOR), 'sector_bytes' bytes per node
+    void read_nodes(const std::vector<int>& beam, char *buffer, size_t sector_bytes) const;
+};
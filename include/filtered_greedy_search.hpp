@@ -1,8 +1,76 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <set>
+#include <vector>
 #include "vectors.hpp"        
 #include "directed_graph.hpp" 
 
+// Optional early termination of the filtered and unfiltered searches, measured on the k-th best candidate. The default
+// values turn it off, so that the search runs until every candidate in L has been expanded
+struct SearchTermination {
+    // Stop after 'patience' expansions that did not improve the distance of the k-th best candidate (0: off)
+    int patience = 0;
+    // Stop when the closest unexpanded candidate is farther than (1 + epsilon) times the k-th best (negative: off)
+    float epsilon = -1;
+    // Adaptive L: only the closest 'initial_L' candidates are expanded at first, and their number is doubled (up to L)
+    // for as long as the top k changes from one round to the next (0: off)
+    int initial_L = 0;
+};
+
+// Marks of the points visited by a search, which a thread reuses for all of its searches. Every search starts a new
+// epoch, so the marks of the previous one are cleared without refilling the array
+class VisitedSet {
+public:
+    // Start a search over 'size' points
+    void clear(size_t size) {
+        if (marks.size() < size) marks.resize(size, 0);
+        if (++epoch == 0) {
+            // Marks of 2^32 searches ago would look current after the epoch wraps around
+            std::fill(marks.begin(), marks.end(), 0);
+            epoch = 1;
+        }
+    }
+    bool operator[](size_t point) const { return marks[point] == epoch; }
+    void insert(size_t point) { marks[point] = epoch; }
+
+private:
+    std::vector<uint32_t> marks;
+    uint32_t epoch = 0;
+};
+
+// The searches are instantiated for DirectedGraph and CompressedGraph, which have the same read interface
+// The filtered and unfiltered searches mark the points they visit in 'visited' if it is given, else in a set of their own
+
+// Search for the k nearest neighbors of 'query' among the points that share a label with it, starting from the start
+// nodes of the query's labels. Returns them and the (distance, index) pairs of every visited point
+// The search stops early on the conditions of 'termination'. Collecting the visited points scans the markers of every
+// point, so queries that only need the neighbors turn it off with 'collect_visited' and get the final L_set instead
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+FilteredGreedySearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit, \
+                     const SearchTermination& termination = SearchTermination(), VisitedSet *visited = nullptr, \
+                     bool collect_visited = true); 
+
+// Same as above, with a single start node
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+FilteredGreedySearch(Graph& graph, Vectors& vectors, int start, int query, int k, int L, int limit); 
+
+// Search for queries without a filter, seeded with multiple start nodes (e.g. the start nodes of all filters)
+// Instead of a complete search per start node, a single visited set is shared by all of them, so every node is
+// expanded at most once and start nodes already reached from previous ones are skipped. Start nodes should be
+// given in ascending distance from the query. Returns the k nearest neighbors found and their (distance, index) pairs
+// The search of every start node stops early on the conditions of 'termination'
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+UnfilteredGreedySearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit, \
+                       const SearchTermination& termination = SearchTermination(), VisitedSet *visited = nullptr);
+
+// Search for queries with a timestamp range. Filtered queries only traverse points that share a label with them, while
+// unfiltered ones traverse every point. Points out of the range are traversed but never returned
+// Returns the k nearest neighbors found in the range and the (distance, index) pairs of every visited point in the range
+template <typename Graph>
 std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
-FilteredGreedySearch(DirectedGraph& graph, Vectors& vectors, int start, int query, int k, int L, int limit); 
\ No newline at end of file
+RangeGreedySearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit);
@@ -3,4 +3,33 @@
 #include "directed_graph.hpp"
 #include "vectors.hpp"
 
-DirectedGraph *filtered_vamana(Vectors& P, float a, int L, int R, std::unordered_map<float, int> *M, bool random_graph_flag, int limit);
\ No newline at end of file
+DirectedGraph *filtered_vamana(Vectors& P, float a, int L, int R, std::vector<int> *M, bool random_graph_flag, int limit);
+
+// Links the (already stored) point 'x' of P into the FilteredVamana graph 'G'
+// If the filter of 'x' is new, 'x' becomes the start node of that filter in M
+void filtered_insert(DirectedGraph *G, Vectors& P, int x, float a, int L, int R, std::vector<int> *M, int limit);
+
+// Stores a new vector with the given filter to P and links it into G. The slot of a freed (deleted) vertex is reused
+// if there is one, otherwise P and G are grown by one. Returns the index of the new vector
+int filtered_insert_vector(DirectedGraph *G, Vectors& P, const float *values, float filter, float a, int L, int R, \
+                           std::vector<int> *M, int limit, float timestamp = 0);
+
+// Inserts all the vectors of a (base vectors format) file to P, reusing freed slots first, and links them into G
+// without rebuilding it
+// Returns the number of inserted vectors
+int filtered_insert_from_file(DirectedGraph *G, Vectors& P, const std::string& file_name, float a, int L, int R, \
+                              std::vector<int> *M, int limit);
+
+// Consolidates the tombstoned vertices of G (FreshVamana-style). Every vertex pointing to deleted ones gets its
+// neighborhood re-pruned over the union of the deleted vertices' neighbors. Deleted points are then removed from
+// the filters' posting lists, start nodes in M are replaced and the freed slots become available for reuse
+// Returns the number of consolidated vertices
+int filtered_consolidate(DirectedGraph *G, Vectors& P, float a, int R, std::vector<int> *M);
+
+// Default fraction of the vertices that must be tombstoned before they are consolidated
+#define CONSOLIDATE_THRESHOLD 0.05
+
+// Consolidates G only once its tombstones are at least 'threshold' of its vertices, so that the deletions of several
+// runs are batched into one pass. Until then, tombstoned vertices are traversed but never returned, and they are saved
+// with the graph. Returns the number of consolidated vertices (0 if the tombstones are below the threshold)
+int filtered_lazy_consolidate(DirectedGraph *G, Vectors& P, float a, int R, std::vector<int> *M, float threshold);
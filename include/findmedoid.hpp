@@ -1,5 +1,23 @@
 #pragma once
 
+#include <vector>
+
 #include "vectors.hpp"
 
-std::unordered_map<float, int> *find_medoid(const Vectors &vectors, int threshold);
\ No newline at end of file
+// For every filter, returns the start node (medoid) that is used by FilteredVamana and by the queries
+// The start node is the point closest to the centroid of the filter's points. The centroid is approximated
+// using a random sample of at most 'threshold' points of the filter
+// The returned array is indexed by label. Labels without points have start node -1
+std::vector<int> *find_medoid(const Vectors &vectors, int threshold);
+
+// Same as find_medoid(), but returns up to 'count' diverse start nodes for every filter
+// The sample of each filter is clustered with k-means (k = 'count') and the point closest to each centroid is chosen
+// If 'medoids' (the result of find_medoid()) is given, the first start node of every filter is its medoid, which stays
+// the centroid of its cluster. Otherwise the first centroid starts at the mean of the sample, but moves like the rest
+// Labels without points have no start nodes
+std::vector<std::vector<int>> *find_start_points(const Vectors &vectors, int threshold, int count,
+                                                 const std::vector<int> *medoids = nullptr);
+
+// Returns the point closest to the centroid of all the points, regardless of their filters
+// The centroid is approximated using a random sample of at most 'threshold' points
+int find_global_medoid(const Vectors &vectors, int threshold);
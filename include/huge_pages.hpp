@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Backing of the large arrays that searches read at random (vector values, compressed neighbor lists, codes) with 2 MB
+// pages, so that far fewer TLB entries cover them than with 4 KB pages. It is off by default and enabled per process
+// with set_huge_pages(). Pages come from the hugetlbfs pool if it has enough free pages, else they are transparent huge
+// pages requested with madvise(), else (e.g. transparent huge pages set to "never") normal pages
+
+#define HUGE_PAGE_SIZE (2UL << 20)
+
+// Pages of a region allocated with huge_alloc()
+enum class PageBacking { NORMAL, TRANSPARENT, HUGETLB };
+
+// Enable or disable huge pages for the regions allocated from now on
+void set_huge_pages(bool enable);
+bool huge_pages_enabled();
+
+// Allocate 'bytes' of zeroed memory. Regions of at least HUGE_PAGE_SIZE are mapped on their own (aligned to
+// HUGE_PAGE_SIZE) and, if huge pages are enabled, backed by them. Smaller regions come from the heap
+// The backing of the region is stored to 'backing', if given
+void *huge_alloc(size_t bytes, PageBacking *backing = nullptr);
+
+// Free a region of huge_alloc(). 'bytes' must be the size it was allocated with
+void huge_free(void *memory, size_t bytes);
+
+// Bytes of the process' memory that are backed by (transparent or hugetlbfs) huge pages, or -1 if it cannot be read
+long huge_page_bytes();
+
+// Allocator of huge_alloc() regions, for std::vector
+template <typename T>
+struct HugePageAllocator {
+    typedef T value_type;
+
+    HugePageAllocator() = default;
+    template <typename U> HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T *allocate(size_t n) {
+        void *memory = huge_alloc(n * sizeof(T));
+        if (memory == nullptr) throw std::bad_alloc();
+        return static_cast<T*>(memory);
+    }
+    void deallocate(T *memory, size_t n) { huge_free(memory, n * sizeof(T)); }
+
+    template <typename U> bool operator==(const HugePageAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const HugePageAllocator<U>&) const { return false; }
+};
+
+// Counts the data TLB misses of loads of the calling thread, with a hardware performance counter, from its construction
+// Counters are not available in most virtual machines and containers, or with a restrictive perf_event_paranoid
+class TlbMissCounter {
+public:
+    TlbMissCounter();
+    ~TlbMissCounter();
+
+    TlbMissCounter(const TlbMissCounter&) = delete;
+    TlbMissCounter& operator=(const TlbMissCounter&) = delete;
+
+    bool available() const { return fd != -1; }
+
+    // Returns the misses counted so far, or -1 if the counter is not available
+    long read() const;
+
+private:
+    int fd;
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>            // std::min
+#include <cstdint>              // uint32_t
+#include <initializer_list>     // std::initializer_list
+#include <vector>               // std::vector
+
+// Filters (labels) are remapped at load time to dense ids 0, 1, ..., num_labels()-1
+typedef uint32_t Label;
+
+// Label of queries without a filter (filter value -1). It matches every label
+#define NO_LABEL UINT32_MAX
+// Label of queries whose filter value does not appear in the base vectors. It matches no label
+#define UNKNOWN_LABEL (UINT32_MAX - 1)
+
+// Sets that only hold labels smaller than this are stored as bitmaps (at most LABEL_BITMAP_BITS / 32 words)
+#define LABEL_BITMAP_BITS 256
+
+// Set of the labels of a point
+// For small vocabularies the set is a bitmap, so intersection and subset tests are a few word-wide ANDs. Once a label
+// of LABEL_BITMAP_BITS or more is inserted, the set switches to a sorted array of labels
+class LabelSet {
+public:
+    // Create an empty set
+    LabelSet() {}
+
+    // Create a set with a single label
+    explicit LabelSet(Label label) { insert(label); }
+
+    // Create a set with the given labels
+    LabelSet(std::initializer_list<Label> labels) { for (Label label : labels) insert(label); }
+
+    // Add 'label' to the set
+    void insert(Label label);
+
+    // Returns true if 'label' is in the set
+    bool contains(Label label) const;
+
+    // Returns true if the set has no labels
+    bool empty() const { return data.empty(); }
+
+    // Number of labels in the set
+    int size() const;
+
+    // Returns the labels of the set in ascending order
+    std::vector<Label> labels() const;
+
+    // Returns true if the two sets have at least one common label
+    bool intersects(const LabelSet& other) const {
+        if (!bitmap || !other.bitmap) return slow_intersects(other);
+
+        size_t n = std::min(data.size(), other.data.size());
+        for (size_t i = 0; i < n; i++) {
+            if (data[i] & other.data[i]) return true;
+        }
+        return false;
+    }
+
+    // Returns true if every label of this set is in 'other'
+    bool subset_of(const LabelSet& other) const {
+        if (!bitmap || !other.bitmap) return slow_subset_of(other);
+
+        for (size_t i = 0; i < data.size(); i++) {
+            uint32_t other_word = i < other.data.size() ? other.data[i] : 0;
+            if (data[i] & ~other_word) return false;
+        }
+        return true;
+    }
+
+    // Returns true if the common labels of this set and 'other' are all in 'cover', i.e. (this ∩ other) ⊆ cover
+    bool common_subset_of(const LabelSet& other, const LabelSet& cover) const {
+        if (!bitmap || !other.bitmap || !cover.bitmap) return slow_common_subset_of(other, cover);
+
+        size_t n = std::min(data.size(), other.data.size());
+        for (size_t i = 0; i < n; i++) {
+            uint32_t cover_word = i < cover.data.size() ? cover.data[i] : 0;
+            if (data[i] & other.data[i] & ~cover_word) return false;
+        }
+        return true;
+    }
+
+    bool operator==(const LabelSet& other) const { return bitmap == other.bitmap && data == other.data; }
+
+private:
+    // Bitmap words (label l is bit l % 32 of word l / 32) or sorted labels. Bitmaps have no trailing zero words
+    std::vector<uint32_t> data;
+    bool bitmap = true;
+
+    // Call 'visit' on the labels of the set in ascending order, without copying them, until it returns false
+    // Returns false if 'visit' stopped it
+    template <typename Visit>
+    bool all_labels(Visit visit) const {
+        if (!bitmap) {
+            for (Label label : data) {
+                if (!visit(label)) return false;
+            }
+            return true;
+        }
+        for (size_t i = 0; i < data.size(); i++) {
+            for (uint32_t word = data[i]; word; word &= word - 1) {
+                if (!visit(Label(i * 32 + __builtin_ctz(word)))) return false;
+            }
+        }
+        return true;
+    }
+
+    // Predicates for sets that are (at least one of them) sorted arrays
+    bool slow_intersects(const LabelSet& other) const;
+    bool slow_subset_of(const LabelSet& other) const;
+    bool slow_common_subset_of(const LabelSet& other, const LabelSet& cover) const;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Every power of two of latencies is split in 2^LATENCY_SUB_BUCKET_BITS linear sub-buckets, so a latency is kept with a
+// relative error of at most 1 / 2^LATENCY_SUB_BUCKET_BITS (about 3%)
+#define LATENCY_SUB_BUCKET_BITS 5
+
+// HDR-style histogram of latencies in microseconds
+// Recording is a few shifts and an increment, and percentiles are answered without keeping every latency
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    // Record a latency of 'value' microseconds
+    void record(long value);
+
+    // Add the latencies of 'other' to this histogram
+    void merge(const LatencyHistogram& other);
+
+    // Number of recorded latencies
+    long count() const { return total; }
+
+    // Largest recorded latency
+    long max() const { return max_value; }
+
+    // Average of the recorded latencies
+    double mean() const { return total ? (double)sum / total : 0; }
+
+    // Returns the p-th percentile (0 <= p <= 100) of the recorded latencies, rounded up to the end of its bucket
+    long percentile(double p) const;
+
+private:
+    std::vector<long> counts;   // Number of latencies of every bucket
+    long total = 0;
+    long sum = 0;
+    long max_value = 0;
+};
+
+// Records the latencies of many queries, in a separate histogram per thread that is merged when they are reported
+class LatencyRecorder {
+public:
+    LatencyRecorder();
+
+    // Record the latency of a query of the current thread that started at 'start'
+    void record(std::chrono::steady_clock::time_point start);
+
+    // Returns the latencies of all threads
+    LatencyHistogram merged() const;
+
+    // Print p50, p90, p99, p99.9 and max latency, and the queries per second over 'seconds' of wall time
+    void print(const std::string& title, double seconds) const;
+
+private:
+    std::vector<LatencyHistogram> histograms;   // Latencies per thread
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Placement of memory and threads on machines with several NUMA nodes (sockets). The topology is read from sysfs and
+// the policies are set with the raw system calls, so libnuma is not needed. On a single node everything still works,
+// but interleaving has no effect
+
+// Parse a list of CPUs or nodes in the format of sysfs (e.g. "0-3,8,10-11"). Returns the ids in ascending order
+std::vector<int> parse_cpu_list(const std::string& list);
+
+// Returns the allowed CPUs of every NUMA node with memory. Without a readable topology, all allowed CPUs form one node
+std::vector<std::vector<int>> numa_node_cpus();
+
+// Order in which threads are assigned to the CPUs of 'node_cpus': consecutive threads go to different nodes, as with
+// OMP_PROC_BIND=spread, so that a smaller number of threads still uses the memory bandwidth of every node
+std::vector<int> spread_cpus(const std::vector<std::vector<int>>& node_cpus);
+
+// Pin every thread of the OpenMP pool (and the calling thread) to a CPU, in the order of spread_cpus()
+// Threads are reused by later parallel regions, so it is enough to call it once before the build or the queries
+// Returns the number of threads pinned
+int pin_threads();
+
+// Set the memory policy of every thread of the OpenMP pool (and of the calling thread): pages they touch from now on
+// are interleaved across all nodes with memory if 'interleave' is set, else they are allocated on the local node of the
+// thread that touches them first. Returns false if there is a single node or the policy could not be set
+bool interleave_memory(bool interleave);
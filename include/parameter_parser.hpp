@@ -1,14 +1,59 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "filtered_greedy_search.hpp"   // SearchTermination
 
 // Parse input arguments for FilteredVamana
 void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::string &base_file, std::string &query_file, std::string &groundtruth_file, \
                       std::string &vamana_file, std::string &save_file, int &base_vectors_num, int &query_vectors_num, \
-                      float &a, int &L, int &t, int &index, int &R, bool &random_graph_flag, int &limit);
+                      float &a, int &L, int &t, int &index, int &R, bool &random_graph_flag, int &limit, std::string &insert_file, \
+                      std::string &delete_file, float &consolidate_threshold, int &entry_points, bool &global_medoid_flag, std::string &labels_file, \
+                      bool &range_flag, int &range_threshold, \
+                      int &brute_force_threshold, int &large_L_threshold, int &L_factor, int &query_chunk, std::string &disk_file, \
+                      int &entry_candidates, SearchTermination &termination, bool &pca_flag, bool &pin_threads_flag, \
+                      bool &interleave_flag, bool &huge_pages_flag);
                       
 // Parse input arguments for StitchedVamana
 void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::string &base_file, std::string &query_file, std::string &groundtruth_file, \
                       std::string &vamana_file, std::string &save_file, int &base_vectors_num, int &query_vectors_num, \
                       float &a, int &L, int &t, int &index, int &L_small, int &R_small, int &R_stitched, \
-                      bool &random_graph_flag, bool &random_medoid_flag, bool &random_subset_medoid_flag, int &limit);
+                      bool &random_graph_flag, bool &random_medoid_flag, bool &random_subset_medoid_flag, int &limit, \
+                      std::string &insert_file, std::string &delete_file, float &consolidate_threshold, int &entry_points, bool &global_medoid_flag, std::string &labels_file, \
+                      bool &range_flag, int &range_threshold, \
+                      int &brute_force_threshold, int &large_L_threshold, int &L_factor, int &query_chunk, std::string &disk_file, \
+                      int &entry_candidates, SearchTermination &termination, bool &pca_flag, bool &pin_threads_flag, \
+                      bool &interleave_flag, bool &huge_pages_flag);
+
+// Parse input arguments for the benchmark of a saved graph. The swept values are given as comma separated lists
+void parse_bench(int vec_dimension, int max_k, int argc, char *argv[], std::string &base_file, std::string &query_file, \
+                 std::string &groundtruth_file, std::string &vamana_file, std::string &output_file, std::string &format, \
+                 int &base_vectors_num, int &query_vectors_num, int &t, std::vector<int> &L_values, std::vector<int> &k_values, \
+                 std::vector<int> &thread_counts, std::string &labels_file, int &limit, int &entry_points, bool &global_medoid_flag, \
+                 int &brute_force_threshold, int &large_L_threshold, int &L_factor, bool &compressed_flag, int &entry_candidates, \
+                 SearchTermination &termination, bool &pca_flag, bool &pin_threads_flag, bool &interleave_flag, \
+                 bool &huge_pages_flag);
+
+// Default maximum number of requests of a batch of the query server
+#define SERVE_MAX_BATCH 1024
+// Default maximum number of connections that the query server serves at once
+#define SERVE_MAX_CONNECTIONS 16
+
+// Parse input arguments for the query server of a saved graph
+void parse_serve(int vec_dimension, int argc, char *argv[], std::string &base_file, std::string &vamana_file, \
+                 std::string &socket_file, int &base_vectors_num, int &t, int &max_batch, int &max_connections, int &cache_size, \
+                 std::string &labels_file, \
+                 int &limit, int &entry_points, bool &global_medoid_flag, int &brute_force_threshold, int &large_L_threshold, \
+                 int &L_factor, int &entry_candidates, SearchTermination &termination, bool &pin_threads_flag, \
+                 bool &interleave_flag, bool &huge_pages_flag);
+
+// Parse input arguments for the search of a disk index. The swept values are given as comma separated lists
+void parse_disk_search(int max_k, int argc, char *argv[], std::string &disk_file, std::string &query_file, \
+                       std::string &groundtruth_file, int &query_vectors_num, std::vector<int> &L_values, \
+                       std::vector<int> &k_values, int &beam_width, bool &huge_pages_flag);
+
+// Parse input arguments for the synthetic dataset generator. 'query_mix' holds the fractions of the 4 query types
+void parse_generate(int argc, char *argv[], std::string &base_file, std::string &query_file, long &base_vectors_num, \
+                    int &query_vectors_num, int &dimension, int &labels, double &zipf, int &clusters, float &spread, \
+                    std::vector<double> &query_mix, unsigned long &seed);
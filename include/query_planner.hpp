@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include "vectors.hpp"
+#include "directed_graph.hpp"
+#include "filtered_greedy_search.hpp"
+
+// Default maximum number of points of a query's labels for which the posting lists are scanned exhaustively
+#define PLANNER_BRUTE_FORCE_THRESHOLD 1000
+// Default maximum number of points of a query's labels for which the graph is searched with a larger L
+#define PLANNER_LARGE_L_THRESHOLD 5000
+// Default factor by which L is multiplied for the large L plan
+#define PLANNER_L_FACTOR 2
+
+// Returns the start nodes of the labels of a filtered query. Labels without points (-1 in 'M') are ignored
+std::vector<int> filter_start_nodes(const LabelSet& filter, std::vector<int> *M);
+
+// Points sampled per start node candidate of a label, for the k-means that chooses the candidates
+#define PLANNER_ENTRY_SAMPLE 10
+
+// Returns the start nodes of 'query' from several candidate start nodes per label (see find_start_points()): for every
+// label of 'filter' (of all labels if it is empty) its candidate closest to the query. Labels without points are ignored
+// The candidates are a small upper level that is scanned first, so the search starts near the query instead of at
+// the medoid of the label
+std::vector<int> closest_start_nodes(const LabelSet& filter, const std::vector<std::vector<int>>& start_points, Vectors& vectors, int query);
+
+// Returns the 'num_entry_points' entry points closest to 'query' (all of them if 0), nearest first
+std::vector<int> nearest_entry_points(const std::vector<int>& entry_points, int num_entry_points, Vectors& vectors, int query);
+
+// Ways to answer a filtered query
+enum QueryPlan { PLAN_BRUTE_FORCE, PLAN_GRAPH_LARGE_L, PLAN_GRAPH };
+
+// Choose the plan of filtered 'query' from the number of points of its labels (the sizes of their posting lists)
+// Up to 'brute_force_threshold' points the posting lists are scanned, up to 'large_L_threshold' the graph is searched
+// with a larger L, else the graph is searched as usual
+QueryPlan plan_filtered_query(const Vectors& vectors, int query, int brute_force_threshold, int large_L_threshold);
+
+// Exact k nearest neighbors of filtered 'query', scanning the posting lists of its labels. Deleted points are skipped
+template <typename Graph>
+std::vector<int> FilteredBruteForce(Graph& graph, Vectors& vectors, int query, int k);
+
+// Answer filtered 'query' with the given plan. 'starts' are the start nodes of its labels. Graph searches stop early
+// on the conditions of 'termination' and mark the points they visit in 'visited', if it is given
+// Both are instantiated for DirectedGraph and CompressedGraph
+template <typename Graph>
+std::vector<int> FilteredSearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, \
+                                QueryPlan plan, int L_factor, const SearchTermination& termination = SearchTermination(), \
+                                VisitedSet *visited = nullptr);
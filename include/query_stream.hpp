@@ -0,0 +1,45 @@
+#pragma once
+
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "vectors.hpp"
+
+// Reads a query file a chunk at a time into the query slots of a Vectors, so that query sets of any size are searched
+// in bounded memory. The next chunk is read in the background while the current one is searched
+// Queries are numbered like read_queries() numbers them (skipped timestamp queries do not count), which is also the
+// order of their groundtruth
+class QueryStream {
+public:
+    // Stream at most 'read_num' queries of 'file_name', 'chunk_size' records at a time
+    // Timestamp queries (types 2 and 3) are skipped, unless 'range_queries' is set
+    QueryStream(const std::string& file_name, int dimension, int read_num, int chunk_size, bool range_queries = false);
+    ~QueryStream();
+
+    // Load the next chunk into query slots 0, 1, ... of 'vectors', which must have at least 'chunk_size' of them
+    // Returns the number of loaded queries, 0 once the file is exhausted
+    int next(Vectors& vectors);
+
+    // Number of the query in slot 0 of the last loaded chunk
+    int first() const { return first_query; }
+
+private:
+    std::ifstream file;
+    int record_size;            // Floats of every query record
+    int chunk_size;
+    bool range_queries;
+    long unread;                // Records of the file that are not read yet
+    int remaining;              // Queries that may still be loaded
+    int first_query = 0;
+    int loaded = 0;             // Queries of the last loaded chunk
+    int requested = 0;          // Records asked by the background read
+
+    std::vector<float> spare;   // Records of the chunk that is loaded to the vectors
+    std::vector<float> buffer;  // Records of the chunk that is read in the background
+    std::future<int> pending;   // Number of records read into 'buffer'
+
+    // Start reading the next chunk into 'buffer'
+    void prefetch();
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vector>
+#include "vectors.hpp"
+#include "directed_graph.hpp"
+
+// Default maximum number of points in a query's range for which they are scanned exhaustively instead of searching the graph
+#define RANGE_BRUTE_FORCE_THRESHOLD 1000
+
+// Exact k nearest neighbors of a range query, scanning the points of its range in the timestamp index of 'vectors'
+// Deleted points and points that do not share a label with the query (if it is filtered) are skipped
+std::vector<int> RangeBruteForce(DirectedGraph& graph, Vectors& vectors, int query, int k);
+
+// Search for the k nearest neighbors of a range query. If at most 'threshold' base vectors have a timestamp in the
+// query's range, they are scanned with RangeBruteForce(), else the graph is searched with RangeGreedySearch()
+// 'starts' are the start nodes of the query's labels (or the entry points of unfiltered queries)
+std::vector<int> RangeSearch(DirectedGraph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit, int threshold);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "label_set.hpp"
+
+// Number of independently locked parts of the cache, so that concurrent lookups rarely wait for each other
+#define RESULT_CACHE_SHARDS 16
+// Default quantization step of the query values. Queries whose values round to the same multiples of it share results
+#define RESULT_CACHE_STEP 0.001
+
+// Bounded cache of search results, keyed by the filter, the quantized query values, k and L
+// Every shard holds a fixed number of entries and evicts with the CLOCK algorithm (an approximation of LRU): a hit marks
+// its entry as referenced, and eviction skips (and unmarks) referenced entries once
+class ResultCache {
+public:
+    // Cache of at most 'capacity' results
+    explicit ResultCache(size_t capacity, float step = RESULT_CACHE_STEP);
+
+    // Returns true and sets 'result' if the results of this query are cached
+    bool lookup(const LabelSet& filter, const float *values, int dimension, int k, int L, std::vector<int>& result);
+
+    // Cache the results of a query, evicting an entry of its shard if it is full
+    void insert(const LabelSet& filter, const float *values, int dimension, int k, int L, const std::vector<int>& result);
+
+    long hits() const { return hit_count; }
+    long misses() const { return miss_count; }
+    long evictions() const { return eviction_count; }
+    double hit_rate() const { return hit_count + miss_count ? (double)hit_count / (hit_count + miss_count) : 0; }
+
+    // Number of cached results
+    size_t size();
+
+private:
+    // Everything a cached result depends on. The codes are the query values divided by the quantization step
+    struct Key {
+        std::vector<Label> labels;
+        std::vector<int32_t> codes;
+        int k, L;
+
+        bool operator==(const Key& other) const {
+            return k == other.k && L == other.L && labels == other.labels && codes == other.codes;
+        }
+    };
+
+    struct Entry {
+        Key key;
+        std::vector<int> result;
+        bool referenced = false;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries;                     // At most 'shard_capacity' entries
+        std::unordered_multimap<uint64_t, int> index;   // Hash of the key to its entry
+        size_t hand = 0;                                // Next eviction candidate of CLOCK
+    };
+
+    size_t shard_capacity;
+    float step;
+    std::vector<Shard> shards;
+    std::atomic<long> hit_count{0}, miss_count{0}, eviction_count{0};
+
+    Key make_key(const LabelSet& filter, const float *values, int dimension, int k, int L) const;
+    static uint64_t hash(const Key& key);
+
+    // Returns the position of 'key' in the entries of 'shard', or -1. The shard must be locked
+    static int find(Shard& shard, const Key& key, uint64_t key_hash);
+};
@@ -7,5 +7,5 @@
 
 // Modifies graph 'G' by setting at most 'R' new out-neighbors for point with index 'p' with given dataset Pf
 // 'V' is an ordered candidate set containing pairs of (euclidean distance, index) and 'a' is the distance threshold where a >= 1
-// 'V' is sorted in ascending euclidean distance between each point and point 'p'
+// 'V' is sorted in ascending euclidean distance between each point and point 'p'. These distances are used by the prune
 void robust_prune(DirectedGraph *G, Vectors& vectors, int *Pf, int p, std::set<std::pair<float, int>>& V, float a, int R);
\ No newline at end of file
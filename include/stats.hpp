@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Instrumentation counters of a single query (or insertion)
+// They are only counted if the code is compiled with -DINSTRUMENTATION (make INSTRUMENTATION=1). Otherwise the STATS_*
+// macros expand to nothing, so the counters cost nothing
+struct SearchStats {
+    long distances = 0;     // Distance evaluations
+    long abandoned = 0;     // Distance evaluations abandoned once they exceeded their bound (also counted in distances)
+    long expansions = 0;    // Nodes expanded (hops)
+    long insertions = 0;    // Insertions to the candidate set
+    long evictions = 0;     // Evictions from the candidate set, when it grows larger than L
+    long visited = 0;       // Reads and writes of the visited table
+};
+
+// Counters of the query (or insertion) that is run by the current thread
+extern thread_local SearchStats thread_stats;
+
+// Collects the counters of many queries (or insertions), in a separate list per thread, and summarizes them
+class StatsCollector {
+public:
+    StatsCollector();
+
+    // Reset the counters of the current thread, before a query starts
+    void begin() { thread_stats = SearchStats(); }
+
+    // Store the counters of the current thread, after a query ends
+    void end();
+
+    // Number of stored queries
+    size_t size() const;
+
+    // Returns the p-th percentile (0 <= p <= 100) of every counter over all stored queries
+    SearchStats percentile(double p) const;
+
+    // Returns the average of every counter over all stored queries (rounded down)
+    SearchStats mean() const;
+
+    // Print the p50, p90, p99 and max of every counter
+    void print(const std::string& title) const;
+
+private:
+    std::vector<std::vector<SearchStats>> samples;  // Counters of every query, per thread
+};
+
+// Counters of every insertion of the graph builders
+extern StatsCollector build_stats;
+
+#ifdef INSTRUMENTATION
+#define STATS_ADD(counter, n) (thread_stats.counter += (n))
+#define STATS_BEGIN(collector) (collector).begin()
+#define STATS_END(collector) (collector).end()
+#define STATS_PRINT(collector, title) (collector).print(title)
+#else
+#define STATS_ADD(counter, n) ((void)0)
+#define STATS_BEGIN(collector) ((void)0)
+#define STATS_END(collector) ((void)0)
+#define STATS_PRINT(collector, title) ((void)0)
+#endif
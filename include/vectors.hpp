@@ -9,6 +9,27 @@
 #include <cstring>
 #include <unordered_set>
 #include <unordered_map>
+#include <cstdint>
+#include <limits>
+
+#include "label_set.hpp"
+
+// Values before the vector values of every query record of a query file: type, filter and timestamp range
+#define QUERY_HEADER 4
+
+// Dimensions after which a bounded distance checks whether it has exceeded its bound (a multiple of 8)
+#define DISTANCE_BLOCK 16
+// Maximum number of base vectors sampled for the principal components of pca_rotate()
+#define PCA_SAMPLE 10000
+
+// Timestamp range [from, to] of a query. Queries without a range match every timestamp
+struct TimeRange {
+    float from = -std::numeric_limits<float>::infinity();
+    float to = std::numeric_limits<float>::infinity();
+
+    bool contains(float timestamp) const { return from <= timestamp && timestamp <= to; }
+    bool bounded() const { return from != -std::numeric_limits<float>::infinity() || to != std::numeric_limits<float>::infinity(); }
+};
 
 class Vectors {
 private:
@@ -17,9 +38,35 @@ private:
     int dimention;              // Dimension of each vector
     int queries;                // Number of queries
 
+    // Maps every filter value to its label. Only used while loading data, never while searching
+    std::unordered_map<float, Label> label_ids;
+
+    // Orthogonal d x d matrix (row major) that every added vector is multiplied with, empty if there is none
+    std::vector<float> rotation;
+
+    // Regions (from huge_alloc()) that hold the values of many vectors back to back, and their sizes in bytes
+    // Vectors that are added one at a time have their own allocation
+    std::vector<std::pair<float*, size_t>> blocks;
+
+    // Allocate a region for the values of 'count' vectors, on huge pages if they are enabled (see set_huge_pages())
+    float *allocate_block(int count);
+
+    // Check if 'values' lie in one of the regions of allocate_block()
+    bool in_block(const float *values) const;
+
+    // Make room for 'count' more base vectors. Queries are moved so that they always follow the base vectors
+    void grow(int count);
+
+    // Multiply 'values' with the rotation, if there is one
+    void rotate(float *values) const;
+
 public:
-    float *filters;             // Store all filters
-    std::unordered_map<float, std::unordered_set<int>> filters_map; // Stores for every filter the indeces they have it
+    LabelSet *filters;          // Store the labels of every vector. Queries without a filter have an empty set
+    std::vector<std::vector<int>> postings; // Stores for every label the (sorted) indeces that have it
+    std::vector<float> label_values;        // Stores for every label its original filter value
+    float *timestamps;          // Store the timestamp of every base vector
+    std::vector<TimeRange> ranges;          // Stores the timestamp range of every query (by query number)
+    std::vector<int> time_index;            // Stores the base vectors' indeces sorted by timestamp
 
     // Load vectors from a file
     Vectors(const std::string& file_name, int vectors_dimention, int num_read_vectors, int queries_num);
@@ -31,21 +78,81 @@ public:
 
     int size() const { return base_size; }
     int dimension() const { return dimention; }
+    int num_queries() const { return queries; }
     float* operator[](int index) const { return vectors[index]; }
 
-    // Check if these two vectors has the same filter
-    bool same_filter(int index1, int index2) {
-        return ((filters[index1] == filters[index2]) || filters[index1] == -1 || filters[index2] == -1);
+    // Number of distinct labels of the base vectors
+    int num_labels() const { return label_values.size(); }
+
+    // Returns the label of a filter value, assigning a new label (with an empty posting list) if the value is new
+    Label add_label(float value);
+
+    // Returns the label of a filter value. Value -1 maps to NO_LABEL and values that have not been seen to UNKNOWN_LABEL
+    Label find_label(float value) const;
+
+    // Remove the base vector at 'index' from the posting lists of its labels
+    void remove_posting(int index);
+
+    // Add the label of a filter value to the base vector at 'index', keeping its posting list sorted
+    void add_filter(int index, float value);
+
+    // Load extra labels of the base vectors from a file (number of vectors, then for each vector the number of its
+    // extra labels followed by their filter values). Labels are added to the one given in the base vectors file
+    void read_labels(const std::string& file_name);
+
+    // Check if these two vectors have a common filter. A vector without filters matches every vector
+    bool same_filter(int index1, int index2) const {
+        return filters[index1].empty() || filters[index2].empty() || filters[index1].intersects(filters[index2]);
     }
 
     // Calculate Euclidean distance between two vectors
     float euclidean_distance(int index1, int index2);
 
-    // Load queries from a file
-    void read_queries(const std::string& file_name, int read_num); 
+    // Calculate Euclidean distance between a vector that is not stored (e.g. a centroid) and the vector at 'index'
+    float euclidean_distance(const float *values, int index) const;
+
+    // Same as euclidean_distance(index1, index2), but once the sum of the first blocks of DISTANCE_BLOCK dimensions
+    // exceeds 'bound' the rest are skipped and that (partial) sum is returned. Distances up to 'bound' are exact
+    float euclidean_distance(int index1, int index2, float bound);
+
+    // Rotate every vector to the principal components of (at most PCA_SAMPLE of) the base vectors, in descending
+    // variance. Distances stay the same, but the leading dimensions carry most of them, so bounded distances are
+    // abandoned sooner. Vectors and queries that are added afterwards are rotated as well. Call it only once
+    void pca_rotate();
+
+    // Check if the timestamp of base vector 'index' is in the range of 'query'
+    bool in_range(int query, int index) const { return ranges[query - base_size].contains(timestamps[index]); }
+
+    // Returns the timestamp range of 'query'
+    const TimeRange& query_range(int query) const { return ranges[query - base_size]; }
+
+    // Sort the base vectors by timestamp. It must be called again after vectors are added or changed
+    void build_time_index();
+
+    // Returns the positions [first, last) of 'time_index' whose vectors have a timestamp in 'range'
+    std::pair<int, int> time_index_bounds(const TimeRange& range) const;
+
+    // Append a new base vector with the given filter, growing the dataset by one
+    // Returns the index of the new vector
+    int add_vector(const float *values, float filter, float timestamp = 0);
+
+    // Overwrite the base vector at 'index' with new values and filter (used when reusing the slot of a deleted vector)
+    void set_vector(int index, const float *values, float filter, float timestamp = 0);
+
+    // Append (copies of) the base vectors of 'other', starting from index 'from', growing the dataset only once
+    // 'other' holds vectors as they were read, so they are rotated if this object has been (see pca_rotate())
+    // Returns the number of vectors appended
+    int append_vectors(const Vectors& other, int from);
+
+    // Store a query record (type, filter, timestamp range and values) in query slot 'slot' (vector base size + slot)
+    // Returns false if it is a timestamp query and 'range_queries' is not set
+    bool set_query(int slot, const float *record, bool range_queries = false);
+
+    // Load queries from a file. Timestamp queries (types 2 and 3) are skipped, unless 'range_queries' is set
+    void read_queries(const std::string& file_name, int read_num, bool range_queries = false); 
 
     // Load the query of the given index from a file
-    bool read_query(const std::string& file_name, int index); 
+    bool read_query(const std::string& file_name, int index, bool range_queries = false); 
 
     // Return the indices of the k-nearest neighboors of the given index
     std::vector<int> query_solutions(const std::string& file_name, int query_index);
@@ -4,7 +4,14 @@
 
 echo -e "\nExecuting all unit tests"
 ./directed_graph_test
+./compressed_graph_test
 ./vectors_test
+./chunked_reader_test
+./label_set_test
+./stats_test
+./latency_test
+./numa_placement_test
+./huge_pages_test
 ./greedy_search_test
 ./filtered_greedy_search_test
 ./robust_prune_test
@@ -12,3 +19,8 @@ echo -e "\nExecuting all unit tests"
 ./vamana_test
 ./findmedoid_test
 ./filtered_vamana_test
+./range_search_test
+./query_planner_test
+./query_stream_test
+./result_cache_test
+./disk_index_test
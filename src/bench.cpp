@@ -0,0 +1,308 @@
+#define VEC_DIMENSION 100
+#define K 100
+
+#include <algorithm>    // std::find()
+#include <chrono>       // For high-resolution clock
+#include <ctime>        // time()
+#include <fstream>      // std::ifstream, std::ofstream
+#include <iostream>     // std::cout
+#include <limits>
+#include <omp.h>        // omp_set_num_threads()
+#include <string>       // std::string
+
+#include "compressed_graph.hpp"
+#include "directed_graph.hpp"
+#include "filtered_greedy_search.hpp"
+#include "findmedoid.hpp"
+#include "huge_pages.hpp"
+#include "latency.hpp"
+#include "numa_placement.hpp"
+#include "parameter_parser.hpp"
+#include "query_planner.hpp"
+#include "stats.hpp"
+#include "utils.hpp"
+#include "vamana.hpp"
+#include "vectors.hpp"
+
+// Execution examples
+
+// ./bench -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -n 10000 -m 5012 -t 50
+// ./bench -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -n 10000 -m 5012 -t 50 -L 20,50,100,200 -k 10,100 -T 1,2,4 -f json -o bench.json
+// ./bench -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -n 10000 -m 5012 -t 50 --compressed
+// ./bench -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -n 10000 -m 5012 -t 50 --entry-candidates 16
+// ./bench -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -n 10000 -m 5012 -t 50 --adaptive-L 20 --patience 10
+// ./bench -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -n 10000 -m 5012 -t 50 --compressed --huge-pages
+
+// Measurements of one configuration of the sweep, for one kind of queries
+struct BenchResult {
+    std::string type;           // "filtered" or "unfiltered", with "-compressed" for the compressed graph
+    int threads, L, k;
+    int queries;
+    double recall;              // Average recall@k
+    double qps;
+    double mean_latency;        // Microseconds
+    long p99_latency;           // Microseconds
+    long distances;             // Average distance computations per query (-1 if not counted)
+    long tlb_misses;            // Average data TLB misses per query (-1 if there is no hardware counter)
+};
+
+// Helper function to read the groundtruth of all queries (K indexes per query, nearest first)
+std::vector<std::vector<int>> read_groundtruth(const std::string& file_name, int query_vectors_num) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    std::vector<std::vector<int>> groundtruth(query_vectors_num, std::vector<int>(K));
+    for (auto& solution : groundtruth) {
+        if (!file.read(reinterpret_cast<char*>(solution.data()), K * sizeof(int))) {
+            throw std::runtime_error("Error reading solution indices from file.");
+        }
+    }
+    return groundtruth;
+}
+
+// Helper function to return the recall@k of 'result', i.e. the fraction of the first k groundtruth points it contains
+double recall_at(const std::vector<int>& result, const std::vector<int>& groundtruth, int k) {
+    int count = 0, found = 0;
+    for (int i = 0; i < k; i++) {
+        if (groundtruth[i] == -1) continue;
+        count++;
+        if (std::find(result.begin(), result.end(), groundtruth[i]) != result.end()) found++;
+    }
+
+    // Queries with fewer matching points than k have nothing more to find
+    return count ? double(found) / count : 1.0;
+}
+
+// Run 'queries' once with the given configuration, searching each query with 'search', and measure them
+template <typename Search>
+BenchResult run_queries(const std::string& type, const std::vector<int>& queries, int base_vectors_num, \
+                        const std::vector<std::vector<int>>& groundtruth, int threads, int L, int k, Search search) {
+    omp_set_num_threads(threads);
+    LatencyRecorder latencies;
+    StatsCollector stats;
+    double recall_sum = 0.0;
+    long tlb_misses = 0;
+    bool tlb_counted = true;
+
+    auto start = std::chrono::steady_clock::now();
+    #pragma omp parallel reduction(+: recall_sum, tlb_misses) reduction(&&: tlb_counted)
+    {
+        // Every thread counts its own misses
+        TlbMissCounter counter;
+
+        #pragma omp for schedule(dynamic, 16)
+        for (size_t i = 0; i < queries.size(); i++) {
+            int j = queries[i];
+
+            STATS_BEGIN(stats);
+            auto search_start = std::chrono::steady_clock::now();
+            std::vector<int> result = search(j + base_vectors_num, k, L);
+            latencies.record(search_start);
+            STATS_END(stats);
+
+            recall_sum += recall_at(result, groundtruth[j], k);
+        }
+
+        tlb_misses += counter.read();
+        tlb_counted = counter.available();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    LatencyHistogram histogram = latencies.merged();
+    BenchResult result;
+    result.type = type;
+    result.threads = threads;
+    result.L = L;
+    result.k = k;
+    result.queries = queries.size();
+    result.recall = queries.empty() ? 0 : recall_sum / queries.size();
+    result.qps = elapsed.count() > 0 ? queries.size() / elapsed.count() : 0;
+    result.mean_latency = histogram.mean();
+    result.p99_latency = histogram.percentile(99);
+    #ifdef INSTRUMENTATION
+    result.distances = stats.mean().distances;
+    #else
+    result.distances = -1;
+    #endif
+    result.tlb_misses = tlb_counted && !queries.empty() ? tlb_misses / (long)queries.size() : -1;
+    return result;
+}
+
+// Write the results as a CSV table (one row per configuration) or as a JSON array of objects
+void write_results(std::ostream& out, const std::vector<BenchResult>& results, const std::string& format) {
+    if (format == "csv") {
+        out << "type,threads,L,k,queries,recall,qps,mean_latency_us,p99_latency_us,distances_per_query,tlb_misses_per_query" << std::endl;
+        for (const auto& r : results) {
+            out << r.type << "," << r.threads << "," << r.L << "," << r.k << "," << r.queries << "," << r.recall << "," \
+                << r.qps << "," << r.mean_latency << "," << r.p99_latency << ",";
+            if (r.distances != -1) out << r.distances;
+            out << ",";
+            if (r.tlb_misses != -1) out << r.tlb_misses;
+            out << std::endl;
+        }
+        return;
+    }
+
+    out << "[" << std::endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "  {\"type\": \"" << r.type << "\", \"threads\": " << r.threads << ", \"L\": " << r.L << ", \"k\": " << r.k \
+            << ", \"queries\": " << r.queries << ", \"recall\": " << r.recall << ", \"qps\": " << r.qps \
+            << ", \"mean_latency_us\": " << r.mean_latency << ", \"p99_latency_us\": " << r.p99_latency \
+            << ", \"distances_per_query\": ";
+        if (r.distances != -1) out << r.distances;
+        else out << "null";
+        out << ", \"tlb_misses_per_query\": ";
+        if (r.tlb_misses != -1) out << r.tlb_misses;
+        else out << "null";
+        out << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    srand(time(NULL));  // Seed for randomization
+
+    std::string base_file, query_file, groundtruth_file, vamana_file, output_file = "", format = "csv", labels_file = "";
+    int base_vectors_num, query_vectors_num, t, limit = std::numeric_limits<int>::max(), entry_points = 0, entry_candidates = 1;
+    bool global_medoid_flag = false, compressed_flag = false, pca_flag = false, pin_threads_flag = false, interleave_flag = false, \
+         huge_pages_flag = false;
+    int brute_force_threshold = PLANNER_BRUTE_FORCE_THRESHOLD, large_L_threshold = PLANNER_LARGE_L_THRESHOLD, \
+        L_factor = PLANNER_L_FACTOR;
+    SearchTermination termination;
+    std::vector<int> L_values = {50, 100, 150, 200}, k_values = {10}, thread_counts = {omp_get_max_threads()};
+
+    parse_bench(VEC_DIMENSION, K, argc, argv, base_file, query_file, groundtruth_file, vamana_file, output_file, format, \
+                base_vectors_num, query_vectors_num, t, L_values, k_values, thread_counts, labels_file, limit, entry_points, \
+                global_medoid_flag, brute_force_threshold, large_L_threshold, L_factor, compressed_flag, \
+                entry_candidates, termination, pca_flag, pin_threads_flag, interleave_flag, huge_pages_flag);
+
+    // Threads are pinned before the pool is used, and the loaded index is interleaved across the NUMA nodes
+    if (pin_threads_flag) std::cout << "Pinned " << pin_threads() << " threads" << std::endl;
+    if (interleave_flag && !interleave_memory(true)) std::cout << "Memory interleaving is not available (single NUMA node)" << std::endl;
+    // The base vectors and the compressed graph are allocated on huge pages, if they are available, from now on
+    set_huge_pages(huge_pages_flag);
+
+    // Load base and queries vectors, the graph and the groundtruth once, for the whole sweep
+    std::cout << "Loading..." << std::endl;
+    Vectors vectors(base_file, VEC_DIMENSION, base_vectors_num, query_vectors_num);
+    // Labels that only the sidecar file has must exist before the queries that filter on them are read
+    if (!labels_file.empty()) vectors.read_labels(labels_file);
+    vectors.read_queries(query_file, query_vectors_num);
+    // Distances do not change, so a graph built from the vectors as they were read can be searched
+    if (pca_flag) vectors.pca_rotate();
+
+    DirectedGraph *g = read_vamana_from_file(vamana_file);
+    ERROR_EXIT(g->get_size() != vectors.size(), "Vamana file does not match the number of base vectors")
+    // Freed vertices of a loaded graph hold no point, so they must not be chosen as start nodes
+    for (auto v : g->get_free_vertices()) vectors.remove_posting(v);
+
+    std::vector<std::vector<int>> groundtruth = read_groundtruth(groundtruth_file, query_vectors_num);
+
+    // Copy of the graph with compressed neighbor lists, searched after the graph in every configuration
+    CompressedGraph *compressed = nullptr;
+    if (compressed_flag) {
+        compressed = new CompressedGraph(*g);
+        std::cout << "Neighbor lists of " << compressed->edges() << " edges: " << compressed->flat_memory() / double(1 << 20) \
+                  << " MB as 32-bit ids, " << compressed->memory() / double(1 << 20) << " MB compressed" << std::endl;
+    }
+
+    // Memory of the queries is allocated on the node of the thread that answers them
+    if (interleave_flag) interleave_memory(false);
+    if (huge_pages_flag) std::cout << huge_page_bytes() / double(1 << 20) << " MB backed by huge pages" << std::endl;
+
+    std::vector<int> *M = find_medoid(vectors, t);
+    std::vector<int> unfiltered_entry_points;
+    for (int start : *M) {
+        if (start != -1) unfiltered_entry_points.push_back(start);
+    }
+    int global_medoid = global_medoid_flag ? find_global_medoid(vectors, t) : -1;
+    if (global_medoid != -1) unfiltered_entry_points.push_back(global_medoid);
+
+    // With several start node candidates per label (the medoid among them), every query starts from the candidates
+    // closest to it
+    std::vector<std::vector<int>> *start_points = nullptr;
+    if (entry_candidates > 1) {
+        start_points = find_start_points(vectors, std::max(t, PLANNER_ENTRY_SAMPLE * entry_candidates), entry_candidates, M);
+    }
+    auto query_entry_points = [&](int query) {
+        if (!start_points) return nearest_entry_points(unfiltered_entry_points, entry_points, vectors, query);
+        std::vector<int> candidates = closest_start_nodes(LabelSet(), *start_points, vectors, query);
+        if (global_medoid != -1) candidates.push_back(global_medoid);
+        return nearest_entry_points(candidates, entry_points, vectors, query);
+    };
+
+    // Split the queries by kind. Filtered queries whose labels have no points have no answer and are skipped
+    std::vector<int> filtered_queries, unfiltered_queries;
+    std::vector<std::vector<int>> starts(query_vectors_num);
+    std::vector<QueryPlan> plans(query_vectors_num);
+    for (int j = 0; j < query_vectors_num; j++) {
+        int query = j + base_vectors_num;
+        const LabelSet& filter = vectors.filters[query];
+        if (filter.empty()) {
+            unfiltered_queries.push_back(j);
+            continue;
+        }
+
+        starts[j] = start_points ? closest_start_nodes(filter, *start_points, vectors, query) : filter_start_nodes(filter, M);
+        if (starts[j].empty()) continue;
+        plans[j] = plan_filtered_query(vectors, query, brute_force_threshold, large_L_threshold);
+        filtered_queries.push_back(j);
+    }
+    std::cout << "Loaded " << filtered_queries.size() << " filtered and " << unfiltered_queries.size() << " unfiltered queries" \
+              << std::endl << std::endl;
+
+    auto filtered_search = [&](int query, int k, int L) {
+        int j = query - base_vectors_num;
+        return FilteredSearch(*g, vectors, starts[j], query, k, L, plans[j], L_factor, termination);
+    };
+    auto unfiltered_search = [&](int query, int k, int L) {
+        return UnfilteredGreedySearch(*g, vectors, query_entry_points(query), query, k, L, limit, termination).first;
+    };
+    auto compressed_filtered_search = [&](int query, int k, int L) {
+        int j = query - base_vectors_num;
+        return FilteredSearch(*compressed, vectors, starts[j], query, k, L, plans[j], L_factor, termination);
+    };
+    auto compressed_unfiltered_search = [&](int query, int k, int L) {
+        return UnfilteredGreedySearch(*compressed, vectors, query_entry_points(query), query, k, L, limit, termination).first;
+    };
+
+    // Warm up the caches with one pass over all queries, so that the first configuration is not measured cold
+    std::cout << "Warming up..." << std::endl;
+    run_queries("filtered", filtered_queries, base_vectors_num, groundtruth, thread_counts[0], L_values[0], k_values[0], filtered_search);
+    run_queries("unfiltered", unfiltered_queries, base_vectors_num, groundtruth, thread_counts[0], L_values[0], k_values[0], unfiltered_search);
+
+    std::vector<BenchResult> results;
+    for (int threads : thread_counts) {
+        for (int L : L_values) {
+            for (int k : k_values) {
+                // Greedy search keeps at most L candidates, so it cannot return more than L neighbors
+                if (L < k) continue;
+
+                std::cout << "Running threads = " << threads << ", L = " << L << ", k = " << k << std::endl;
+                results.push_back(run_queries("filtered", filtered_queries, base_vectors_num, groundtruth, threads, L, k, filtered_search));
+                results.push_back(run_queries("unfiltered", unfiltered_queries, base_vectors_num, groundtruth, threads, L, k, unfiltered_search));
+                if (!compressed) continue;
+                results.push_back(run_queries("filtered-compressed", filtered_queries, base_vectors_num, groundtruth, threads, L, k, \
+                                              compressed_filtered_search));
+                results.push_back(run_queries("unfiltered-compressed", unfiltered_queries, base_vectors_num, groundtruth, threads, L, k, \
+                                              compressed_unfiltered_search));
+            }
+        }
+    }
+    std::cout << std::endl;
+
+    if (output_file.empty()) write_results(std::cout, results, format);
+    else {
+        std::ofstream out(output_file);
+        if (!out) throw std::runtime_error("Error opening file: " + output_file);
+        write_results(out, results, format);
+        std::cout << "Results written to " << output_file << std::endl;
+    }
+
+    delete g;
+    delete compressed;
+    delete start_points;
+    delete M;
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+
+#include "build_profile.hpp"
+
+BuildProfile build_profile;
+
+// Names of the phases, as printed in the summary
+static const char *PHASE_NAMES[NUM_BUILD_PHASES] = {
+    "medoid", "greedy_search", "robust_prune", "back_edges", "stitching", "final_prune"
+};
+
+BuildProfile::BuildProfile() : seconds(omp_get_max_threads()) {
+    for (auto& thread_seconds : seconds) thread_seconds.fill(0.0);
+}
+
+// Start reporting progress of a build that will insert 'total' points
+void BuildProfile::begin(long total) {
+    this->total = total;
+    points = 0;
+    start = std::chrono::steady_clock::now();
+    next_report = BUILD_PROGRESS_INTERVAL * 1000;
+}
+
+// Add 'seconds' to 'phase' for the current thread
+void BuildProfile::add(BuildPhase phase, double seconds) {
+    size_t thread = omp_get_thread_num();
+    if (thread < this->seconds.size()) this->seconds[thread][phase] += seconds;
+}
+
+// Count an inserted point. The thread that finds the interval passed moves the next report forward and prints
+void BuildProfile::point_done() {
+    long done = ++points;
+    if (total == 0) return;
+
+    long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    long report = next_report;
+    if (elapsed < report || !next_report.compare_exchange_strong(report, elapsed + BUILD_PROGRESS_INTERVAL * 1000)) return;
+
+    #pragma omp critical(build_progress)
+    std::cout << "Built " << done << " / " << total << " points (" << 100 * done / total << "%), " \
+              << (long)(done / (elapsed / 1000.0)) << " points/s on average" << std::endl;
+}
+
+// Total seconds of 'phase' over all threads
+double BuildProfile::phase_seconds(BuildPhase phase) const {
+    double sum = 0.0;
+    for (const auto& thread_seconds : seconds) sum += thread_seconds[phase];
+    return sum;
+}
+
+// Print the time of every phase and a machine-readable summary line
+void BuildProfile::print(double wall_seconds) const {
+    std::cout << "Build phases (seconds, summed over threads):" << std::endl;
+    for (int phase = 0; phase < NUM_BUILD_PHASES; phase++) {
+        std::cout << "  " << std::left << std::setw(14) << PHASE_NAMES[phase] << std::right \
+                  << phase_seconds((BuildPhase)phase) << std::endl;
+    }
+
+    std::cout << "Build profile: {\"points\": " << points << ", \"wall_seconds\": " << wall_seconds \
+              << ", \"points_per_second\": " << (wall_seconds > 0 ? points / wall_seconds : 0);
+    for (int phase = 0; phase < NUM_BUILD_PHASES; phase++) {
+        std::cout << ", \"" << PHASE_NAMES[phase] << "\": " << phase_seconds((BuildPhase)phase);
+    }
+    std::cout << "}" << std::endl << std::endl;
+}
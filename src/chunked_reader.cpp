@@ -0,0 +1,204 @@
+#include <algorithm>        // std::min(), std::max()
+#include <cstdlib>          // posix_memalign(), free()
+#include <cstring>          // std::memcpy(), std::memset()
+#include <fcntl.h>          // open()
+#include <linux/io_uring.h> // io_uring structures
+#include <stdexcept>        // std::runtime_error
+#include <sys/mman.h>       // mmap(), munmap()
+#include <sys/stat.h>       // fstat()
+#include <sys/syscall.h>    // __NR_io_uring_*
+#include <unistd.h>         // pread(), close(), syscall()
+
+#include "chunked_reader.hpp"
+
+IoRing::~IoRing() {
+    if (ring_fd != -1) close();
+}
+
+bool IoRing::setup(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int ring = syscall(__NR_io_uring_setup, entries, &params);
+    if (ring < 0) return false;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        ::close(ring);
+        return false;
+    }
+    cq_ring = sq_ring;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        cq_ring = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+    }
+    sqes = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+    if (cq_ring == MAP_FAILED || sqes == MAP_FAILED) {
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        munmap(sq_ring, sq_ring_size);
+        ::close(ring);
+        return false;
+    }
+
+    char *sq = static_cast<char*>(sq_ring), *cq = static_cast<char*>(cq_ring);
+    sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+    // Completions of a full submission ring must fit in the completion ring as well
+    num_entries = std::min(params.sq_entries, params.cq_entries);
+    ring_fd = ring;
+    return true;
+}
+
+void IoRing::close() {
+    munmap(sqes, sqes_size);
+    if (cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    munmap(sq_ring, sq_ring_size);
+    ::close(ring_fd);
+    ring_fd = -1;
+    queued = 0;
+}
+
+void IoRing::queue_read(int fd, void *buffer, size_t bytes, off_t offset, uint64_t tag) {
+    unsigned tail = *sq_tail, index = tail & *sq_mask;
+    io_uring_sqe *sqe = static_cast<io_uring_sqe*>(sqes) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<unsigned long>(buffer);
+    sqe->len = bytes;
+    sqe->off = offset;
+    sqe->user_data = tag;
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    queued++;
+}
+
+bool IoRing::submit(unsigned wait) {
+    unsigned count = queued;
+    queued = 0;
+    return syscall(__NR_io_uring_enter, ring_fd, count, wait, wait ? IORING_ENTER_GETEVENTS : 0, nullptr, 0) >= 0;
+}
+
+uint64_t IoRing::complete(int& result) {
+    unsigned head = *cq_head;
+    while (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+        syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+    }
+    io_uring_cqe *cqe = static_cast<io_uring_cqe*>(cqes) + (head & *cq_mask);
+    result = cqe->res;
+    uint64_t tag = cqe->user_data;
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    return tag;
+}
+
+ChunkedReader::ChunkedReader(const std::string& file_name, size_t chunk_size, bool use_io_uring) : chunk_size(chunk_size) {
+    fd = open(file_name.c_str(), O_RDONLY);
+    if (fd == -1) throw std::runtime_error("Error opening file: " + file_name);
+
+    struct stat info;
+    fstat(fd, &info);
+    file_size = info.st_size;
+    // The whole file is read sequentially
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    for (auto& buffer : buffers) {
+        if (posix_memalign(reinterpret_cast<void**>(&buffer), 4096, chunk_size) != 0) throw std::bad_alloc();
+    }
+
+    // 2 entries are enough for the single read in flight
+    if (use_io_uring) ring.setup(2);
+    submit();
+}
+
+ChunkedReader::~ChunkedReader() {
+    // The read in flight must not write to the buffers after they are freed. Its errors do not matter anymore
+    if (in_flight) {
+        try { wait(); } catch (const std::runtime_error&) {}
+    }
+
+    for (auto buffer : buffers) free(buffer);
+    close(fd);
+}
+
+void ChunkedReader::submit() {
+    if (next_offset >= file_size) return;
+
+    char *buffer = buffers[1 - current];
+    requested = std::min(static_cast<off_t>(chunk_size), file_size - next_offset);
+    off_t offset = next_offset;
+    next_offset += requested;
+    in_flight = true;
+
+    if (!ring.available()) {
+        pending = std::async(std::launch::async, [this, buffer, offset, bytes = requested] {
+            return pread(fd, buffer, bytes, offset);
+        });
+        return;
+    }
+
+    ring.queue_read(fd, buffer, requested, offset, 0);
+    if (!ring.submit()) throw std::runtime_error("Error submitting read to io_uring");
+}
+
+void ChunkedReader::wait() {
+    ssize_t count;
+    if (!ring.available()) {
+        count = pending.get();
+    } else {
+        int result;
+        ring.complete(result);
+        count = result;
+
+        // Kernels 5.1 to 5.5 set up rings but fail IORING_OP_READ with -EINVAL. If the first read fails, the ring is
+        // dropped and the chunk is read again with pread() below, as are the next ones
+        if (count < 0 && !ring_verified) {
+            ring.close();
+            count = 0;
+        }
+        ring_verified = true;
+    }
+    in_flight = false;
+    if (count < 0) throw std::runtime_error("Error reading file");
+
+    // Reads may return fewer bytes than asked, so the rest of the chunk is read here
+    char *buffer = buffers[1 - current];
+    off_t offset = next_offset - requested;
+    while ((size_t)count < requested) {
+        ssize_t more = pread(fd, buffer + count, requested - count, offset + count);
+        if (more <= 0) break;
+        count += more;
+    }
+
+    current = 1 - current;
+    position = 0;
+    length = count;
+}
+
+bool ChunkedReader::read(void *data, size_t bytes) {
+    char *destination = static_cast<char*>(data);
+    while (bytes > 0) {
+        if (position == length) {
+            if (!in_flight) return false;
+            wait();
+            // Read the next chunk while this one is decoded
+            submit();
+            if (length == 0) return false;
+        }
+
+        size_t count = std::min(bytes, length - position);
+        std::memcpy(destination, buffers[current] + position, count);
+        destination += count;
+        position += count;
+        bytes -= count;
+    }
+    return true;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>    // std::sort()
+#include <cstring>      // std::memcpy()
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>  // _mm_shuffle_epi8()
+#endif
+
+#include "compressed_graph.hpp"
+
+// Bytes needed for 'value' (1 to 4)
+static inline int byte_length(uint32_t value) {
+    if (value < (1u << 8)) return 1;
+    if (value < (1u << 16)) return 2;
+    if (value < (1u << 24)) return 3;
+    return 4;
+}
+
+size_t stream_vbyte_encode(const uint32_t *values, size_t count, uint8_t *out) {
+    uint8_t *control = out, *position = out + (count + 3) / 4;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 4 == 0) control[i / 4] = 0;
+        int length = byte_length(values[i]);
+        control[i / 4] |= (length - 1) << (2 * (i % 4));
+        // Little endian, so the first bytes of the value are its low bytes
+        std::memcpy(position, &values[i], length);
+        position += length;
+    }
+    return position - out;
+}
+
+#ifdef __SSSE3__
+// Shuffle masks that spread the data bytes of 4 values into 4 lanes, and the number of data bytes, per control byte
+struct ShuffleTable {
+    alignas(16) uint8_t masks[256][16];
+    uint8_t lengths[256];
+
+    ShuffleTable() {
+        for (int control = 0; control < 256; control++) {
+            int source = 0;
+            for (int i = 0; i < 4; i++) {
+                int length = ((control >> (2 * i)) & 3) + 1;
+                for (int b = 0; b < 4; b++) masks[control][4 * i + b] = b < length ? source++ : 0x80;
+            }
+            lengths[control] = source;
+        }
+    }
+};
+static const ShuffleTable shuffle_table;
+#endif
+
+void stream_vbyte_decode(const uint8_t *in, size_t count, uint32_t *out) {
+    const uint8_t *control = in, *position = in + (count + 3) / 4;
+    size_t i = 0;
+
+#ifdef __SSSE3__
+    for (; i + 4 <= count; i += 4) {
+        uint8_t c = control[i / 4];
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(position));
+        __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle_table.masks[c]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(bytes, mask));
+        position += shuffle_table.lengths[c];
+    }
+#endif
+
+    for (; i < count; i++) {
+        int length = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        uint32_t value = 0;
+        std::memcpy(&value, position, length);
+        out[i] = value;
+        position += length;
+    }
+}
+
+CompressedGraph::CompressedGraph(const DirectedGraph& graph) : size(graph.get_size()) {
+    offsets.resize(size + 1);
+    degrees.resize(size);
+    deleted.resize(size);
+
+    std::vector<uint32_t> deltas;
+    std::vector<uint8_t> encoded;
+    for (int v = 0; v < size; v++) {
+        const auto& neighbors = graph.get_neighbors(v);
+        deltas.assign(neighbors.begin(), neighbors.end());
+        std::sort(deltas.begin(), deltas.end());
+        for (size_t i = deltas.size(); i-- > 1; ) deltas[i] -= deltas[i - 1];
+
+        encoded.resize((deltas.size() + 3) / 4 + 4 * deltas.size());
+        size_t bytes = stream_vbyte_encode(deltas.data(), deltas.size(), encoded.data());
+        offsets[v] = data.size();
+        data.insert(data.end(), encoded.begin(), encoded.begin() + bytes);
+
+        degrees[v] = deltas.size();
+        deleted[v] = graph.is_deleted(v);
+        num_edges += deltas.size();
+    }
+    offsets[size] = data.size();
+
+    // Decoding loads 16 bytes at a time
+    data.resize(data.size() + 16, 0);
+    data.shrink_to_fit();
+}
+
+const std::vector<Vertex>& CompressedGraph::get_neighbors(Vertex v) const {
+    thread_local std::vector<Vertex> buffer;
+    uint32_t degree = degrees[v];
+    buffer.resize(degree);
+
+    uint32_t *values = reinterpret_cast<uint32_t*>(buffer.data());
+    stream_vbyte_decode(&data[offsets[v]], degree, values);
+    // Undo the delta encoding
+    for (uint32_t i = 1; i < degree; i++) values[i] += values[i - 1];
+    return buffer;
+}
+
+size_t CompressedGraph::memory() const {
+    return data.size() + offsets.size() * sizeof(uint64_t) + degrees.size() * sizeof(uint16_t) + deleted.size() / 8;
+}
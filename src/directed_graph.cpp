@@ -1,4 +1,5 @@
 #include <iostream>
+#include <utility>      // std::move
 
 #include "directed_graph.hpp"
 #include "utils.hpp"
@@ -7,11 +8,13 @@
 DirectedGraph::DirectedGraph(int num_of_vertices) {
     neighbors_size = num_of_vertices;
     neighbors = new std::unordered_set<Vertex>[num_of_vertices];
+    deleted = new bool[num_of_vertices]();
 }
 
 // De-allocate memory
 DirectedGraph::~DirectedGraph() {
     delete [] neighbors;
+    delete [] deleted;
 }
 
 // Insert edge ('source', 'destination') to graph
@@ -50,6 +53,54 @@ void DirectedGraph::stitch(DirectedGraph *g, int *Pf) {
     }
 }
 
+// Grow the graph to 'num_of_vertices' vertices. The new vertices have no edges and existing edges are kept
+void DirectedGraph::resize(int num_of_vertices) {
+    ERROR_EXIT(num_of_vertices < neighbors_size, "Graph cannot shrink")
+
+    // Move (instead of copying) the existing sets to the new array
+    std::unordered_set<Vertex> *new_neighbors = new std::unordered_set<Vertex>[num_of_vertices];
+    bool *new_deleted = new bool[num_of_vertices]();
+    for (int i = 0 ; i < neighbors_size ; i++) {
+        new_neighbors[i] = std::move(neighbors[i]);
+        new_deleted[i] = deleted[i];
+    }
+
+    delete [] neighbors;
+    delete [] deleted;
+    neighbors = new_neighbors;
+    deleted = new_deleted;
+    neighbors_size = num_of_vertices;
+}
+
+// Mark vertex 'v' as deleted (tombstone). Its edges are kept, so that it can still be traversed until consolidation
+void DirectedGraph::mark_deleted(Vertex v) {
+    ERROR_EXIT(v < 0 || v >= neighbors_size, "Invalid index (vertex)")
+
+    // Deleting a vertex twice has no effect
+    if (deleted[v]) return;
+    deleted[v] = true;
+    tombstones.push_back(v);
+}
+
+// Remove all out-edges of the tombstoned vertices and make their slots available for reuse
+void DirectedGraph::free_tombstones() {
+    for (auto v : tombstones) {
+        neighbors[v].clear();
+        free_vertices.push_back(v);
+    }
+    tombstones.clear();
+}
+
+// Returns a freed vertex which is no longer deleted, so it can be used for a new point. Returns -1 if there is none
+Vertex DirectedGraph::reuse_vertex() {
+    if (free_vertices.empty()) return -1;
+
+    Vertex v = free_vertices.back();
+    free_vertices.pop_back();
+    deleted[v] = false;
+    return v;
+}
+
 // Returns a reference to an unordered-set that contains the neighbors of vertex 'v'. 'const' is used to prevent data modification
 const std::unordered_set<Vertex>& DirectedGraph::get_neighbors(Vertex v) const {
     ERROR_EXIT(v < 0 || v >= neighbors_size, "Invalid index (vertex)")
@@ -0,0 +1,337 @@
+#include <algorithm>    // std::min(), std::max(), std::sort()
+#include <cmath>        // std::lround()
+#include <cstdint>      // uintptr_t
+#include <cstring>      // std::memcpy(), std::memcmp()
+#include <fcntl.h>      // open()
+#include <fstream>      // std::ofstream, std::ifstream
+#include <limits>       // std::numeric_limits
+#include <set>          // std::set
+#include <stdexcept>    // std::runtime_error
+#include <unistd.h>     // pread(), close()
+#include <unordered_set>
+
+#include "chunked_reader.hpp"
+#include "disk_index.hpp"
+#include "stats.hpp"
+
+// First bytes of a disk index file
+static const char DISK_MAGIC[8] = {'V', 'A', 'M', 'D', 'I', 'S', 'K', '1'};
+
+// Contents of the header sector
+struct DiskHeader {
+    char magic[8];
+    uint32_t points, dimension, max_degree, labels;
+    uint64_t memory_offset;     // Offset of the data that is kept in memory
+};
+
+// Node layout shared by the writer and the reader. Nodes that fit in a sector never cross a sector boundary
+static void node_layout(int dimension, int max_degree, size_t& node_size, int& nodes_per_sector, int& sectors_per_node) {
+    node_size = (dimension + 1 + max_degree) * sizeof(float);
+    nodes_per_sector = DISK_SECTOR / node_size;
+    sectors_per_node = nodes_per_sector ? 1 : (node_size + DISK_SECTOR - 1) / DISK_SECTOR;
+}
+
+static off_t layout_offset(int point, size_t node_size, int nodes_per_sector, int sectors_per_node) {
+    // Sector 0 is the header
+    if (nodes_per_sector == 0) return (off_t)(1 + (off_t)point * sectors_per_node) * DISK_SECTOR;
+    return (off_t)(1 + point / nodes_per_sector) * DISK_SECTOR + (point % nodes_per_sector) * node_size;
+}
+
+void write_disk_index(const DirectedGraph& graph, const Vectors& vectors, std::vector<int> *M, const std::string& file_name) {
+    std::ofstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    int points = graph.get_size(), dimension = vectors.dimension(), max_degree = 0;
+    for (int i = 0; i < points; i++) max_degree = std::max(max_degree, (int)graph.get_neighbors(i).size());
+
+    size_t node_size;
+    int nodes_per_sector, sectors_per_node;
+    node_layout(dimension, max_degree, node_size, nodes_per_sector, sectors_per_node);
+    int sectors = nodes_per_sector ? (points + nodes_per_sector - 1) / nodes_per_sector : points * sectors_per_node;
+
+    DiskHeader header;
+    std::memcpy(header.magic, DISK_MAGIC, sizeof(DISK_MAGIC));
+    header.points = points;
+    header.dimension = dimension;
+    header.max_degree = max_degree;
+    header.labels = vectors.num_labels();
+    header.memory_offset = (uint64_t)(1 + sectors) * DISK_SECTOR;
+
+    std::vector<char> sector(DISK_SECTOR, 0);
+    std::memcpy(sector.data(), &header, sizeof(header));
+    file.write(sector.data(), DISK_SECTOR);
+
+    // Nodes, a sector (or the sectors of one node) at a time
+    std::vector<char> block((size_t)sectors_per_node * DISK_SECTOR);
+    int per_block = nodes_per_sector ? nodes_per_sector : 1;
+    for (int first = 0; first < points; first += per_block) {
+        std::fill(block.begin(), block.end(), 0);
+        for (int i = first; i < std::min(points, first + per_block); i++) {
+            char *node = block.data() + (i - first) * (nodes_per_sector ? node_size : 0);
+            std::memcpy(node, vectors[i], dimension * sizeof(float));
+
+            const auto& neighbors = graph.get_neighbors(i);
+            uint32_t degree = neighbors.size();
+            std::memcpy(node + dimension * sizeof(float), &degree, sizeof(degree));
+            std::vector<int32_t> list(neighbors.begin(), neighbors.end());
+            std::memcpy(node + (dimension + 1) * sizeof(float), list.data(), degree * sizeof(int32_t));
+        }
+        file.write(block.data(), block.size());
+    }
+
+    // 8-bit scalar quantization, with the range of every dimension over the points
+    std::vector<float> minimum(dimension, std::numeric_limits<float>::max()), maximum(dimension, std::numeric_limits<float>::lowest());
+    for (int i = 0; i < points; i++) {
+        if (graph.is_deleted(i)) continue;
+        for (int d = 0; d < dimension; d++) {
+            minimum[d] = std::min(minimum[d], vectors[i][d]);
+            maximum[d] = std::max(maximum[d], vectors[i][d]);
+        }
+    }
+    std::vector<float> step(dimension);
+    for (int d = 0; d < dimension; d++) {
+        if (minimum[d] > maximum[d]) minimum[d] = maximum[d] = 0;
+        step[d] = maximum[d] > minimum[d] ? (maximum[d] - minimum[d]) / 255 : 1;
+    }
+    file.write(reinterpret_cast<const char*>(minimum.data()), dimension * sizeof(float));
+    file.write(reinterpret_cast<const char*>(step.data()), dimension * sizeof(float));
+
+    std::vector<uint8_t> code(dimension);
+    for (int i = 0; i < points; i++) {
+        for (int d = 0; d < dimension; d++) {
+            long value = std::lround((vectors[i][d] - minimum[d]) / step[d]);
+            code[d] = std::min(255L, std::max(0L, value));
+        }
+        file.write(reinterpret_cast<const char*>(code.data()), dimension);
+    }
+
+    // Labels of every point, the filter value of every label and its start node
+    for (int i = 0; i < points; i++) {
+        std::vector<Label> labels = vectors.filters[i].labels();
+        uint32_t count = labels.size();
+        file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char*>(labels.data()), count * sizeof(Label));
+    }
+    file.write(reinterpret_cast<const char*>(vectors.label_values.data()), header.labels * sizeof(float));
+    std::vector<int32_t> starts(header.labels, -1);
+    for (size_t label = 0; label < starts.size() && label < M->size(); label++) starts[label] = (*M)[label];
+    file.write(reinterpret_cast<const char*>(starts.data()), starts.size() * sizeof(int32_t));
+
+    std::vector<uint8_t> deleted(points);
+    for (int i = 0; i < points; i++) deleted[i] = graph.is_deleted(i);
+    file.write(reinterpret_cast<const char*>(deleted.data()), points);
+
+    if (!file) throw std::runtime_error("Error writing file: " + file_name);
+}
+
+DiskIndex::DiskIndex(const std::string& file_name, bool use_io_uring) : use_io_uring(use_io_uring) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    DiskHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, DISK_MAGIC, sizeof(DISK_MAGIC))) {
+        throw std::runtime_error("Not a disk index file: " + file_name);
+    }
+    points = header.points;
+    dims = header.dimension;
+    max_degree = header.max_degree;
+    node_layout(dims, max_degree, node_size, nodes_per_sector, sectors_per_node);
+
+    // Load the data that is kept in memory
+    file.seekg(header.memory_offset);
+    minimum.resize(dims);
+    step.resize(dims);
+    codes.resize((size_t)points * dims);
+    file.read(reinterpret_cast<char*>(minimum.data()), dims * sizeof(float));
+    file.read(reinterpret_cast<char*>(step.data()), dims * sizeof(float));
+    file.read(reinterpret_cast<char*>(codes.data()), codes.size());
+
+    filters.resize(points);
+    std::vector<Label> labels;
+    for (int i = 0; i < points; i++) {
+        uint32_t count;
+        file.read(reinterpret_cast<char*>(&count), sizeof(count));
+        labels.resize(count);
+        file.read(reinterpret_cast<char*>(labels.data()), count * sizeof(Label));
+        for (Label label : labels) filters[i].insert(label);
+    }
+
+    std::vector<float> label_values(header.labels);
+    file.read(reinterpret_cast<char*>(label_values.data()), header.labels * sizeof(float));
+    for (Label label = 0; label < header.labels; label++) label_ids[label_values[label]] = label;
+    start_nodes.resize(header.labels);
+    file.read(reinterpret_cast<char*>(start_nodes.data()), header.labels * sizeof(int32_t));
+
+    std::vector<uint8_t> deleted_bytes(points);
+    if (!file.read(reinterpret_cast<char*>(deleted_bytes.data()), points)) throw std::runtime_error("Error reading file: " + file_name);
+    deleted.assign(deleted_bytes.begin(), deleted_bytes.end());
+    file.close();
+
+    // Nodes are read by several threads at once, with O_DIRECT if the file system supports it (tmpfs does not)
+    fd = open(file_name.c_str(), O_RDONLY | O_DIRECT);
+    direct = fd != -1;
+    if (!direct) fd = open(file_name.c_str(), O_RDONLY);
+    if (fd == -1) throw std::runtime_error("Error opening file: " + file_name);
+}
+
+DiskIndex::~DiskIndex() {
+    close(fd);
+}
+
+Label DiskIndex::find_label(float value) const {
+    if (value == -1) return NO_LABEL;
+    auto it = label_ids.find(value);
+    return it != label_ids.end() ? it->second : UNKNOWN_LABEL;
+}
+
+float DiskIndex::code_distance(const float *query, int point) const {
+    const uint8_t *code = &codes[(size_t)point * dims];
+    float sum = 0;
+    for (int d = 0; d < dims; d++) {
+        float difference = query[d] - (minimum[d] + code[d] * step[d]);
+        sum += difference * difference;
+    }
+    return sum;
+}
+
+off_t DiskIndex::node_offset(int point) const {
+    return layout_offset(point, node_size, nodes_per_sector, sectors_per_node);
+}
+
+void DiskIndex::read_nodes(const std::vector<int>& beam, char *buffer, size_t sector_bytes) const {
+    // Every thread has its own ring, set up by its first search
+    thread_local IoRing ring;
+    thread_local bool ring_tried = false, ring_verified = false;
+    if (use_io_uring && !ring_tried) {
+        ring_tried = true;
+        ring.setup(DISK_RING_ENTRIES);
+    }
+
+    // Bytes that must be read for the whole node of 'b' to be in the buffer
+    auto needed = [&](size_t b) { return (ssize_t)(node_offset(beam[b]) % DISK_SECTOR + node_size); };
+    auto sector = [&](size_t b) { return node_offset(beam[b]) / DISK_SECTOR * DISK_SECTOR; };
+
+    size_t b = 0;
+    while (use_io_uring && ring.available() && b < beam.size()) {
+        size_t batch = std::min(beam.size() - b, (size_t)ring.entries());
+        for (size_t i = b; i < b + batch; i++) ring.queue_read(fd, buffer + i * sector_bytes, sector_bytes, sector(i), i);
+        if (!ring.submit(batch)) throw std::runtime_error("Error submitting reads to io_uring");
+
+        bool failed = false;
+        for (size_t i = 0; i < batch; i++) {
+            int result;
+            size_t read = ring.complete(result);
+            if (result < 0 && !ring_verified) failed = true;
+            else if (result < needed(read)) throw std::runtime_error("Error reading disk index node");
+        }
+        // Kernels 5.1 to 5.5 set up rings but fail IORING_OP_READ, so the batch is read again with pread() below
+        if (failed) {
+            ring.close();
+            break;
+        }
+        ring_verified = true;
+        b += batch;
+    }
+
+    for (; b < beam.size(); b++) {
+        if (pread(fd, buffer + b * sector_bytes, sector_bytes, sector(b)) < needed(b)) {
+            throw std::runtime_error("Error reading disk index node");
+        }
+    }
+}
+
+std::vector<int> DiskIndex::search(const float *query, const LabelSet& filter, int k, int L, int beam_width, long *reads) const {
+    // Filtered queries start from the start nodes of their labels, unfiltered ones from the start nodes of all labels
+    std::vector<int> starts;
+    if (filter.empty()) {
+        for (int start : start_nodes) if (start != -1) starts.push_back(start);
+    } else {
+        for (Label label : filter.labels()) {
+            if (label < start_nodes.size() && start_nodes[label] != -1) starts.push_back(start_nodes[label]);
+        }
+    }
+
+    auto matches = [&](int point) { return filter.empty() || filters[point].intersects(filter); };
+
+    // The expanded nodes, ranked by their full precision distance
+    std::vector<std::pair<float, int>> expanded;
+    std::unordered_set<int> visited, done;
+
+    // O_DIRECT reads need a buffer aligned to the sectors
+    size_t sector_bytes = (size_t)sectors_per_node * DISK_SECTOR;
+    std::vector<char> storage(beam_width * sector_bytes + DISK_SECTOR);
+    char *buffer = storage.data() + (DISK_SECTOR - reinterpret_cast<uintptr_t>(storage.data()) % DISK_SECTOR) % DISK_SECTOR;
+    std::vector<int> beam;
+
+    // Beam search from 'seeds', with candidates ranked by their codes
+    auto beam_search = [&](const std::vector<int>& seeds) {
+        std::set<std::pair<float, int>> L_set;
+        for (int seed : seeds) {
+            if (visited.insert(seed).second) L_set.insert({code_distance(query, seed), seed});
+        }
+
+        while (true) {
+            // The 'beam_width' best candidates that are not expanded yet
+            beam.clear();
+            for (auto it = L_set.begin(); it != L_set.end() && (int)beam.size() < beam_width; it++) {
+                if (!done.count(it->second)) beam.push_back(it->second);
+            }
+            if (beam.empty()) break;
+
+            // Read the sectors of their nodes together
+            read_nodes(beam, buffer, sector_bytes);
+            if (reads) *reads += beam.size() * sectors_per_node;
+            STATS_ADD(expansions, beam.size());
+
+            for (size_t b = 0; b < beam.size(); b++) {
+                int node = beam[b];
+                done.insert(node);
+                const char *data = &buffer[b * sector_bytes] + (node_offset(node) % DISK_SECTOR);
+
+                const float *values = reinterpret_cast<const float*>(data);
+                float distance = 0;
+                for (int d = 0; d < dims; d++) distance += (query[d] - values[d]) * (query[d] - values[d]);
+                STATS_ADD(distances, 1);
+                if (!deleted[node] && matches(node)) expanded.push_back({distance, node});
+
+                uint32_t degree;
+                std::memcpy(&degree, data + dims * sizeof(float), sizeof(degree));
+                const int32_t *neighbors = reinterpret_cast<const int32_t*>(data + (dims + 1) * sizeof(float));
+                for (uint32_t j = 0; j < degree; j++) {
+                    int neighbor = neighbors[j];
+                    if (matches(neighbor) && visited.insert(neighbor).second) {
+                        L_set.insert({code_distance(query, neighbor), neighbor});
+                        STATS_ADD(insertions, 1);
+                    }
+                }
+            }
+
+            // Restrict L_set to a maximum size of L
+            if (L_set.size() > static_cast<size_t>(L)) {
+                auto it = L_set.begin();
+                std::advance(it, L);
+                L_set.erase(it, L_set.end());
+            }
+        }
+    };
+
+    // Filtered queries search from the start nodes of their labels together. As in UnfilteredGreedySearch, unfiltered
+    // queries search from every start node separately, since the labels are weakly connected to each other
+    if (!filter.empty()) beam_search(starts);
+    else {
+        for (int start : starts) {
+            if (!visited.count(start)) beam_search({start});
+        }
+    }
+
+    std::sort(expanded.begin(), expanded.end());
+    std::vector<int> result;
+    for (int i = 0; i < k && i < (int)expanded.size(); i++) result.push_back(expanded[i].second);
+    return result;
+}
+
+size_t DiskIndex::memory() const {
+    size_t bytes = codes.size() + (minimum.size() + step.size()) * sizeof(float) + start_nodes.size() * sizeof(int) + points / 8;
+    for (const auto& filter : filters) bytes += sizeof(LabelSet) + filter.size() * sizeof(Label);
+    return bytes;
+}
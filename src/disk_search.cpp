@@ -0,0 +1,107 @@
+#define K 100
+
+#include <algorithm>    // std::find()
+#include <chrono>       // For high-resolution clock
+#include <fstream>      // std::ifstream
+#include <iostream>     // std::cout
+#include <string>       // std::string
+
+#include "disk_index.hpp"
+#include "huge_pages.hpp"
+#include "parameter_parser.hpp"
+#include "utils.hpp"
+#include "vectors.hpp"
+
+// Search of a disk index, which keeps only the compact codes, labels and start nodes in memory. The full precision
+// vectors and the neighbor lists are read from the file while searching
+
+// Execution examples
+
+// ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -n 10000 -m 5012 -a 1.2 -L 100 -R 40 -t 50 --disk vamana.disk
+// ./disk_search -d vamana.disk -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -m 5012 -L 50,100 -k 10,100 -W 4
+// ./disk_search -d vamana.disk -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -m 5012 -H
+
+// Helper function to return the recall@k of 'result', i.e. the fraction of the first k groundtruth points it contains
+static double recall_at(const std::vector<int>& result, const int *groundtruth, int k) {
+    int count = 0, found = 0;
+    for (int i = 0; i < k; i++) {
+        if (groundtruth[i] == -1) continue;
+        count++;
+        if (std::find(result.begin(), result.end(), groundtruth[i]) != result.end()) found++;
+    }
+
+    // Queries with fewer matching points than k have nothing more to find
+    return count ? double(found) / count : 1.0;
+}
+
+int main(int argc, char *argv[]) {
+    std::string disk_file, query_file, groundtruth_file;
+    int query_vectors_num, beam_width = DISK_BEAM_WIDTH;
+    bool huge_pages_flag = false;
+    std::vector<int> L_values = {50, 100, 150, 200}, k_values = {10};
+
+    parse_disk_search(K, argc, argv, disk_file, query_file, groundtruth_file, query_vectors_num, L_values, k_values, beam_width, \
+                      huge_pages_flag);
+    // The codes, which every step of the search reads at random, are allocated on huge pages if they are available
+    set_huge_pages(huge_pages_flag);
+
+    auto start = std::chrono::steady_clock::now();
+    DiskIndex index(disk_file);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Loaded disk index of " << index.size() << " points in " << elapsed.count() << " seconds" << std::endl;
+    // Compared with the vectors and the neighbor lists, which stay in the file
+    std::cout << "Memory used: " << index.memory() / (1 << 20) << " MB (codes, labels and start nodes), nodes on disk: " \
+              << index.node_bytes() / (1 << 20) << " MB" << std::endl;
+    std::cout << "Nodes are read " << (index.reads_direct() ? "with O_DIRECT" : "through the page cache") << std::endl;
+
+    // Queries with a filter or without one, in the same order as the groundtruth. Timestamp queries are skipped
+    std::ifstream file(query_file, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + query_file);
+    uint32_t records;
+    ERROR_EXIT(!file.read(reinterpret_cast<char*>(&records), sizeof(records)), "Error reading query file")
+
+    int dimension = index.dimension();
+    std::vector<float> record(QUERY_HEADER + dimension), queries;
+    std::vector<LabelSet> filters;
+    while ((int)filters.size() < query_vectors_num && records-- > 0) {
+        if (!file.read(reinterpret_cast<char*>(record.data()), record.size() * sizeof(float))) break;
+        if (record[0] > 1) continue;
+
+        Label label = index.find_label(record[1]);
+        filters.push_back(label != NO_LABEL ? LabelSet(label) : LabelSet());
+        queries.insert(queries.end(), record.begin() + QUERY_HEADER, record.end());
+    }
+    int queries_num = filters.size();
+
+    std::ifstream groundtruth_stream(groundtruth_file, std::ios::binary);
+    if (!groundtruth_stream) throw std::runtime_error("Error opening file: " + groundtruth_file);
+    std::vector<int> groundtruth((size_t)queries_num * K);
+    ERROR_EXIT(!groundtruth_stream.read(reinterpret_cast<char*>(groundtruth.data()), groundtruth.size() * sizeof(int)), \
+               "Error reading groundtruth file")
+    std::cout << "Loaded " << queries_num << " queries" << std::endl << std::endl;
+
+    for (int L : L_values) {
+        for (int k : k_values) {
+            // The search keeps at most L candidates, so it cannot return more than L neighbors
+            if (L < k) continue;
+
+            double recall_sum = 0.0;
+            long reads = 0;
+            start = std::chrono::steady_clock::now();
+            #pragma omp parallel for reduction(+: recall_sum, reads) schedule(dynamic, 16)
+            for (int j = 0; j < queries_num; j++) {
+                long query_reads = 0;
+                std::vector<int> result = index.search(&queries[(size_t)j * dimension], filters[j], k, L, beam_width, &query_reads);
+                recall_sum += recall_at(result, &groundtruth[(size_t)j * K], k);
+                reads += query_reads;
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+            double seconds = elapsed.count();
+
+            std::cout << "L = " << L << ", k = " << k << ": recall = " << (queries_num ? recall_sum / queries_num * 100 : 0) \
+                      << "%, QPS = " << (seconds > 0 ? queries_num / seconds : 0) << ", sectors read per query = " \
+                      << (queries_num ? double(reads) / queries_num : 0) << std::endl;
+        }
+    }
+    return 0;
+}
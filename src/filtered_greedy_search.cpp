@@ -1,50 +1,142 @@
 #include <unordered_set>
 #include <vector>
 #include <algorithm> 
+#include <limits>
 #include "utils.hpp"
+#include "compressed_graph.hpp"
 #include "filtered_greedy_search.hpp"
+#include "stats.hpp"
 
-std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
-FilteredGreedySearch(DirectedGraph& graph, Vectors& vectors, int start, int query, int k, int L, int limit) {
-    size_t vectors_size = vectors.size();
+// Main search loop shared by the filtered and the unfiltered search. Expands the closest unvisited node among the first
+// 'window' nodes of 'L_set' (all of them if 0) until all of them have been visited (or 'limit' iterations have passed),
+// keeping at most L nodes in it. Nodes past the window are kept, so a later call with a larger window resumes the search
+// If 'filtered' is set, only neighbors that share a label with the query are considered
+// The loop stops early on the conditions of 'termination', measured on the k-th node of L_set. Returns the iterations
+// left of 'limit'
+template <typename Graph>
+static int beam_search(Graph& graph, Vectors& vectors, std::set<std::pair<float, int>>& L_set, VisitedSet& visited, int query, int L, int limit, bool filtered, \
+                       int k = 0, const SearchTermination& termination = SearchTermination(), int window = 0) {
+    if (window <= 0 || window > L) window = L;
 
-    // Initialize result set and visited marker array
-    std::set<std::pair<float, int>> L_set;
-    bool *visited = new bool[vectors_size];
-    std::fill(visited, visited + vectors_size, false);
-
-    // Insert to L_set the start node if it has the same filter with the query
-    if (vectors.same_filter(query, start)) {
-        L_set.insert({vectors.euclidean_distance(query, start), start});
-    }
+    // Distances are squared, so the epsilon factor is as well
+    bool early = k > 0 && (termination.patience > 0 || termination.epsilon >= 0);
+    float factor = (1 + termination.epsilon) * (1 + termination.epsilon);
+    float best_kth = std::numeric_limits<float>::max();
+    int stale = 0;
 
-    // Main search loop
     while (--limit) {
-        // Find first unvisited node in L_set
-        auto p_star = std::find_if(L_set.begin(), L_set.end(), [&](const auto& pair) {
-            return !visited[pair.second];
-        });
-        if (p_star == L_set.end()) {
-            break; // Exit if all nodes in L_set have been visited
+        // Find first unvisited node in the window of L_set
+        auto p_star = L_set.begin();
+        int position = 0;
+        while (p_star != L_set.end() && position < window && visited[p_star->second]) {
+            p_star++;
+            position++;
+        }
+        STATS_ADD(visited, position + 1);
+        if (p_star == L_set.end() || position == window) {
+            break; // Exit if all nodes in the window have been visited
         }
-        
-        visited[p_star->second] = true;
 
-        // Insert neighbors with distances
+        if (early && L_set.size() >= static_cast<unsigned long int>(k)) {
+            float kth = std::next(L_set.begin(), k - 1)->first;
+
+            // Stop if the k-th best candidate has not improved for 'patience' expansions
+            if (kth < best_kth) {
+                best_kth = kth;
+                stale = 0;
+            } else if (termination.patience > 0 && ++stale >= termination.patience) {
+                break;
+            }
+
+            // Stop if the closest unexpanded candidate is unlikely to lead to a better one
+            if (termination.epsilon >= 0 && p_star->first > factor * kth) break;
+        }
+
+        visited.insert(p_star->second);
+        STATS_ADD(visited, 1);
+        STATS_ADD(expansions, 1);
+
+        // Insert neighbors with distances. Once L_set is full, a neighbor farther than its last node would be evicted right
+        // away, so its distance is abandoned as soon as it exceeds that of the last node
         const auto& neighbors = graph.get_neighbors(p_star->second);
+        STATS_ADD(visited, neighbors.size());
+        float bound = L_set.size() >= static_cast<unsigned long int>(L) ? std::prev(L_set.end())->first : std::numeric_limits<float>::max();
         for (auto neighbor : neighbors) {
-            if (!visited[neighbor]) {
-                L_set.insert({vectors.euclidean_distance(query, neighbor), neighbor});
+            if (!visited[neighbor] && (!filtered || vectors.same_filter(query, neighbor))) {
+                float distance = vectors.euclidean_distance(query, neighbor, bound);
+                if (distance > bound) continue;
+
+                L_set.insert({distance, neighbor});
+                STATS_ADD(insertions, 1);
+                if (L_set.size() > static_cast<unsigned long int>(L)) {
+                    L_set.erase(std::prev(L_set.end()));
+                    STATS_ADD(evictions, 1);
+                }
+                if (L_set.size() == static_cast<unsigned long int>(L)) bound = std::prev(L_set.end())->first;
             }
         }
 
-        // Restrict L_set to a maximum size of L
+        // Restrict L_set to a maximum size of L (it may start with more start nodes)
         if (L_set.size() > static_cast<unsigned long int>(L)) {
+            STATS_ADD(evictions, L_set.size() - L);
             auto it = L_set.end();
             std::advance(it, -(L_set.size() - L));
             L_set.erase(it, L_set.end());
         }
     }
+    return limit;
+}
+
+// beam_search() with the adaptive L of 'termination': the window of expanded candidates starts at its initial L and is
+// doubled until the top k of L_set is the same after two rounds, or the window reaches L. Without it, a single round
+// expands all of L
+template <typename Graph>
+static void adaptive_beam_search(Graph& graph, Vectors& vectors, std::set<std::pair<float, int>>& L_set, VisitedSet& visited, int query, int k, int L, int limit, \
+                                 bool filtered, const SearchTermination& termination) {
+    int window = termination.initial_L > 0 ? std::min(std::max(termination.initial_L, k), L) : L;
+
+    std::vector<int> previous, top;
+    while (true) {
+        limit = beam_search(graph, vectors, L_set, visited, query, L, limit, filtered, k, termination, window);
+        if (window == L || limit <= 0) break;
+
+        top.clear();
+        for (auto it = L_set.begin(); it != L_set.end() && (int)top.size() < k; it++) top.push_back(it->second);
+        if (top == previous) break;
+
+        previous.swap(top);
+        window = std::min(2 * window, L);
+    }
+}
+
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+FilteredGreedySearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit, \
+                     const SearchTermination& termination, VisitedSet *visited_set, bool collect_visited) {
+    size_t vectors_size = vectors.size();
+
+    // Initialize result set and visited markers
+    std::set<std::pair<float, int>> L_set;
+    VisitedSet own_visited;
+    VisitedSet& visited = visited_set ? *visited_set : own_visited;
+    visited.clear(vectors_size);
+
+    // Insert to L_set the start nodes that have a common filter with the query
+    for (int start : starts) {
+        if (vectors.same_filter(query, start)) {
+            L_set.insert({vectors.euclidean_distance(query, start), start});
+            STATS_ADD(insertions, 1);
+        }
+    }
+
+    // Main search loop
+    adaptive_beam_search(graph, vectors, L_set, visited, query, k, L, limit, true, termination);
+
+    // Deleted (tombstoned) vertices are traversed but never returned
+    for (auto it = L_set.begin(); it != L_set.end(); ) {
+        if (graph.is_deleted(it->second)) it = L_set.erase(it);
+        else it++;
+    }
 
     // Collect top k results
     std::vector<int> result;
@@ -53,13 +145,125 @@ FilteredGreedySearch(DirectedGraph& graph, Vectors& vectors, int start, int quer
         result.push_back(it->second);
     }
 
+    if (!collect_visited) return {result, L_set};
+
     // Add the deleted visited indeces to L_set
+    STATS_ADD(visited, vectors_size);
     for (size_t i = 0; i < vectors_size; i++) {
-        if (visited[i]) {
+        if (visited[i] && !graph.is_deleted(i)) {
             L_set.insert({vectors.euclidean_distance(query, i), i});
         }
     }
 
-    delete[] visited;
     return {result, L_set};
-}
\ No newline at end of file
+}
+
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+FilteredGreedySearch(Graph& graph, Vectors& vectors, int start, int query, int k, int L, int limit) {
+    return FilteredGreedySearch(graph, vectors, std::vector<int>{start}, query, k, L, limit);
+}
+
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+UnfilteredGreedySearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit, \
+                       const SearchTermination& termination, VisitedSet *visited_set) {
+    // A single set of visited markers is shared by all start nodes, so that every node is expanded at most once
+    VisitedSet own_visited;
+    VisitedSet& visited = visited_set ? *visited_set : own_visited;
+    visited.clear(vectors.size());
+
+    // Merged top k results of every start node
+    std::set<std::pair<float, int>> K_set;
+    for (int start : starts) {
+        // The start node was already reached from a previous start node, so its neighborhood has been searched
+        if (visited[start]) continue;
+
+        std::set<std::pair<float, int>> L_set;
+        L_set.insert({vectors.euclidean_distance(query, start), start});
+        STATS_ADD(insertions, 1);
+        adaptive_beam_search(graph, vectors, L_set, visited, query, k, L, limit, false, termination);
+
+        // Keep the k closest (non-deleted) nodes of this start node
+        int count = 0;
+        for (auto it = L_set.begin(); it != L_set.end() && count < k; it++) {
+            if (graph.is_deleted(it->second)) continue;
+            K_set.insert(*it);
+            count++;
+        }
+
+        // Restrict K_set to a maximum size of k
+        if (K_set.size() > static_cast<unsigned long int>(k)) {
+            auto it = K_set.begin();
+            std::advance(it, k);
+            K_set.erase(it, K_set.end());
+        }
+    }
+
+    // Collect top k results
+    std::vector<int> result;
+    for (const auto& pair : K_set) {
+        result.push_back(pair.second);
+    }
+
+    return {result, K_set};
+}
+
+template <typename Graph>
+std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
+RangeGreedySearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit) {
+    size_t vectors_size = vectors.size();
+    bool filtered = !vectors.filters[query].empty();
+
+    // As in UnfilteredGreedySearch, every start node is searched separately, sharing a single set of visited markers
+    VisitedSet visited;
+    visited.clear(vectors_size);
+
+    std::set<std::pair<float, int>> K_set;
+    for (int start : starts) {
+        if (visited[start] || !vectors.same_filter(query, start)) continue;
+
+        std::set<std::pair<float, int>> L_set;
+        L_set.insert({vectors.euclidean_distance(query, start), start});
+        STATS_ADD(insertions, 1);
+        beam_search(graph, vectors, L_set, visited, query, L, limit, filtered);
+
+        // Nodes left unvisited in L_set (if the limit was reached) are candidates as well
+        for (const auto& pair : L_set) {
+            if (!visited[pair.second] && !graph.is_deleted(pair.second) && vectors.in_range(query, pair.second)) {
+                K_set.insert(pair);
+            }
+        }
+    }
+
+    // Points out of the range are traversed, so that the graph stays navigable, but only the ones in range are kept
+    STATS_ADD(visited, vectors_size);
+    for (size_t i = 0; i < vectors_size; i++) {
+        if (visited[i] && !graph.is_deleted(i) && vectors.in_range(query, i)) {
+            K_set.insert({vectors.euclidean_distance(query, i), i});
+        }
+    }
+
+    // Collect top k results
+    std::vector<int> result;
+    auto it = K_set.begin();
+    for (int i = 0; i < k && it != K_set.end(); i++, it++) {
+        result.push_back(it->second);
+    }
+
+    return {result, K_set};
+}
+
+// The searches run on the graph that is built and on its compressed copy
+#define INSTANTIATE_SEARCHES(Graph) \
+    template std::pair<std::vector<int>, std::set<std::pair<float, int>>> \
+    FilteredGreedySearch(Graph&, Vectors&, const std::vector<int>&, int, int, int, int, const SearchTermination&, VisitedSet*, bool); \
+    template std::pair<std::vector<int>, std::set<std::pair<float, int>>> \
+    FilteredGreedySearch(Graph&, Vectors&, int, int, int, int, int); \
+    template std::pair<std::vector<int>, std::set<std::pair<float, int>>> \
+    UnfilteredGreedySearch(Graph&, Vectors&, const std::vector<int>&, int, int, int, int, const SearchTermination&, VisitedSet*); \
+    template std::pair<std::vector<int>, std::set<std::pair<float, int>>> \
+    RangeGreedySearch(Graph&, Vectors&, const std::vector<int>&, int, int, int, int);
+
+INSTANTIATE_SEARCHES(DirectedGraph)
+INSTANTIATE_SEARCHES(CompressedGraph)
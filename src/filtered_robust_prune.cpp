@@ -39,13 +39,15 @@ void filtered_robust_prune(DirectedGraph *G, Vectors& vectors, int p, std::set<s
             int p_prime = it->second;
 
             // If Fp' intersect Fp is not a subset of Fp* continue
-            if (vectors.same_filter(p_prime, p) && !vectors.same_filter(p_prime, p_star)) {
+            if (!vectors.filters[p_prime].common_subset_of(vectors.filters[p], vectors.filters[p_star])) {
                 it++;
                 continue;
             }
 
-            // if a ⋅ d(p*, p') <= d(p, p') then remove p' from V
-            if (a * vectors.euclidean_distance(p_star, p_prime) <= vectors.euclidean_distance(p, p_prime)) it = V.erase(it);
+            // if a ⋅ d(p*, p') <= d(p, p') then remove p' from V. As in robust_prune.cpp, d(p, p') is the distance stored
+            // in V and d(p*, p') is abandoned once it exceeds d(p, p') / a
+            float bound = it->first / a;
+            if (a * vectors.euclidean_distance(p_star, p_prime, bound) <= it->first) it = V.erase(it);
             else it++;
         }
     }
@@ -1,13 +1,19 @@
 #include <algorithm>
+#include <limits>
 #include <random>
+#include <set>
+#include <vector>
 
+#include "build_profile.hpp"
 #include "filtered_greedy_search.hpp"
 #include "filtered_robust_prune.hpp"
 #include "filtered_vamana.hpp"
 #include "findmedoid.hpp"
+#include "stats.hpp"
+#include "utils.hpp"
 #include "vamana.hpp"
 
-DirectedGraph *filtered_vamana(Vectors& P, float a, int L, int R, std::unordered_map<float, int> *M, bool random_graph_flag, int limit) {
+DirectedGraph *filtered_vamana(Vectors& P, float a, int L, int R, std::vector<int> *M, bool random_graph_flag, int limit) {
     int n = P.size();
     // Initialize G to an empty or random graph
     DirectedGraph *G; 
@@ -26,16 +32,43 @@ DirectedGraph *filtered_vamana(Vectors& P, float a, int L, int R, std::unordered
     auto rng = std::default_random_engine { rd() };
     std::shuffle(sigma, sigma + n, rng);
 
+    build_profile.begin(n);
     for (int i = 0; i < n; i++) {
-        float Fx = P.filters[sigma[i]]; // Filter of current index
-        int s = M->at(Fx); // Medoid point of this filter
+        filtered_insert(G, P, sigma[i], a, L, R, M, limit);
+    }
+
+    delete[] sigma;
+
+    return G;
+}
 
-        auto V_Fx = FilteredGreedySearch(*G, P, s, sigma[i], 0, L, limit).second;
-        filtered_robust_prune(G, P, sigma[i], V_Fx, a, R);
+// Links the (already stored) point 'x' of P into the FilteredVamana graph 'G'
+void filtered_insert(DirectedGraph *G, Vectors& P, int x, float a, int L, int R, std::vector<int> *M, int limit) {
+    STATS_BEGIN(build_stats);
+
+    // Start nodes of the filters of the current index. A point with a new filter becomes the start node of that filter
+    if (M->size() < (size_t)P.num_labels()) M->resize(P.num_labels(), -1);
+    std::vector<int> S_Fx;
+    for (Label f : P.filters[x].labels()) {
+        if ((*M)[f] == -1) (*M)[f] = x;
+        S_Fx.push_back((*M)[f]);
+    }
+
+    std::set<std::pair<float, int>> V_Fx;
+    {
+        PhaseTimer timer(PHASE_GREEDY_SEARCH);
+        V_Fx = FilteredGreedySearch(*G, P, S_Fx, x, 0, L, limit).second;
+    }
+    {
+        PhaseTimer timer(PHASE_ROBUST_PRUNE);
+        filtered_robust_prune(G, P, x, V_Fx, a, R);
+    }
 
-        const auto& N_out_sigma_i = G->get_neighbors(sigma[i]);
-        for (auto j : N_out_sigma_i) {
-            G->insert(j, sigma[i]);
+    {
+        PhaseTimer timer(PHASE_BACK_EDGES);
+        const auto& N_out_x = G->get_neighbors(x);
+        for (auto j : N_out_x) {
+            G->insert(j, x);
             const auto& N_out_j = G->get_neighbors(j);
 
             if ((int)N_out_j.size() > R) {
@@ -48,7 +81,115 @@ DirectedGraph *filtered_vamana(Vectors& P, float a, int L, int R, std::unordered
         }
     }
 
-    delete[] sigma;
+    STATS_END(build_stats);
+    build_profile.point_done();
+}
 
-    return G;
+// Appends a new vector with the given filter to P, grows G and links the new vertex into it
+int filtered_insert_vector(DirectedGraph *G, Vectors& P, const float *values, float filter, float a, int L, int R, \
+                           std::vector<int> *M, int limit, float timestamp) {
+    ERROR_EXIT(G->get_size() != P.size(), "Graph and vectors are out of sync")
+
+    // Prefer reusing the slot of a consolidated (deleted) point
+    int x = G->reuse_vertex();
+    if (x != -1) {
+        P.set_vector(x, values, filter, timestamp);
+    } else {
+        x = P.add_vector(values, filter, timestamp);
+        G->resize(P.size());
+    }
+    filtered_insert(G, P, x, a, L, R, M, limit);
+
+    return x;
+}
+
+// Appends all the vectors of a (base vectors format) file to P and links them into G without rebuilding it
+int filtered_insert_from_file(DirectedGraph *G, Vectors& P, const std::string& file_name, float a, int L, int R, \
+                              std::vector<int> *M, int limit) {
+    ERROR_EXIT(G->get_size() != P.size(), "Graph and vectors are out of sync")
+
+    Vectors new_vectors(file_name, P.dimension(), std::numeric_limits<int>::max(), 0);
+    int count = new_vectors.size();
+    build_profile.begin(count);
+
+    // Slots of deleted points are reused first
+    int i = 0;
+    for (; i < count && !G->get_free_vertices().empty(); i++) {
+        // Files of base vectors hold a single filter per vector
+        Label label = new_vectors.filters[i].labels()[0];
+        filtered_insert_vector(G, P, new_vectors[i], new_vectors.label_values[label], a, L, R, M, limit, new_vectors.timestamps[i]);
+    }
+
+    // The rest are appended at once, so that both P and G are only grown once
+    int first = P.size();
+    P.append_vectors(new_vectors, i);
+    G->resize(P.size());
+
+    // New points are linked in the order they appear in the file
+    for (int x = first; x < P.size(); x++) {
+        filtered_insert(G, P, x, a, L, R, M, limit);
+    }
+
+    return count;
+}
+
+// Consolidates the tombstoned vertices of G (FreshVamana-style)
+int filtered_consolidate(DirectedGraph *G, Vectors& P, float a, int R, std::vector<int> *M) {
+    const std::vector<Vertex>& D = G->get_tombstones();
+    if (D.empty()) return 0;
+    int n = G->get_size();
+
+    // Every vertex is handled by a single thread, which is the only one modifying its out-neighbors. Other threads
+    // only read the neighbors of deleted vertices, which do not change until they are freed below
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int p = 0; p < n; p++) {
+        if (G->is_deleted(p)) continue;
+
+        // Find the deleted out-neighbors of p. Most vertices have none and are skipped
+        std::vector<int> deleted_neighbors;
+        for (auto v : G->get_neighbors(p)) {
+            if (G->is_deleted(v)) deleted_neighbors.push_back(v);
+        }
+        if (deleted_neighbors.empty()) continue;
+
+        // C <- (Nout(p) U Nout(v) for every deleted v in Nout(p)) \ D
+        std::set<std::pair<float, int>> C;
+        for (auto v : deleted_neighbors) {
+            G->remove(p, v);
+            for (auto w : G->get_neighbors(v)) {
+                if (w != p && !G->is_deleted(w)) C.insert({P.euclidean_distance(p, w), w});
+            }
+        }
+
+        // The remaining (non-deleted) out-neighbors of p are added to C by filtered_robust_prune()
+        filtered_robust_prune(G, P, p, C, a, R);
+    }
+
+    // Deleted points must not be chosen as start nodes, nor be found in posting lists anymore
+    for (auto v : D) P.remove_posting(v);
+    for (size_t f = 0; f < M->size(); f++) {
+        int old_start = (*M)[f];
+        if (old_start == -1 || !G->is_deleted(old_start)) continue;
+
+        // Replace a deleted start node with the closest remaining point of the same filter (-1 if there is none)
+        (*M)[f] = -1;
+        float min = std::numeric_limits<float>::max();
+        for (auto v : P.postings[f]) {
+            float dist = P.euclidean_distance(old_start, v);
+            if (dist < min) {
+                min = dist;
+                (*M)[f] = v;
+            }
+        }
+    }
+
+    int count = D.size();
+    G->free_tombstones();
+    return count;
+}
+
+int filtered_lazy_consolidate(DirectedGraph *G, Vectors& P, float a, int R, std::vector<int> *M, float threshold) {
+    size_t tombstones = G->get_tombstones().size();
+    if (tombstones == 0 || tombstones < threshold * G->get_size()) return 0;
+    return filtered_consolidate(G, P, a, R, M);
 }
\ No newline at end of file
@@ -1,47 +1,170 @@
-#include <cstdlib>
-#include <ctime>
+#include <algorithm>
+#include <limits>
+#include <random>
 #include <vector>
 
+#include "build_profile.hpp"
 #include "findmedoid.hpp"
 #include "utils.hpp"
 
-// Alternative implementation of FindMedoid(), leveraging the fact that each
-// vector (index) maps to only one filter
-std::unordered_map<float, int> *find_medoid(const Vectors &vectors, int threshold) {
-    std::srand(std::time(nullptr));
-    
-    // Map M mapping filters to start nodes: key=filter, value:start-index
-    std::unordered_map<float, int> *M = new std::unordered_map<float, int>;
-
-    // For each filter, Rf contains `threshold` num of elements
-    int *Rf = new int[threshold];
-
-    for (const auto& pair : vectors.filters_map) { // For every filter
-        float f = pair.first; // Current filter
-        const std::unordered_set<int>& Pf = pair.second; // Indexes matching the filter
-
-        // min(threshold, Pf.size())
-        int n = Pf.size();
-        if (threshold < n)
-            n = threshold;
-
-        // Select `n` random samples from Pf
-        // We need to conver Pf to a vector to work with array-based indexes
-        int index;
-        std::vector<int> Pf_vector(Pf.begin(), Pf.end());
+// Number of Lloyd iterations used to refine the centroids of a filter
+#define KMEANS_ITERATIONS 10
+
+// Computes 'k' centroids of the sample S with Lloyd's algorithm. The first centroid is the mean of S (or 'pinned', which
+// then stays fixed) and the rest are initialized with a farthest-first traversal, so that they are spread across the
+// points of the filter. Returns the centroids as a flat array of k * dimension floats
+static std::vector<float> kmeans(const Vectors &vectors, const std::vector<int> &S, int k, const float *pinned = nullptr) {
+    int d = vectors.dimension();
+    int n = S.size();
+    std::vector<float> centroids(k * d, 0.0);
+
+    // Centroid 0 is the mean of the sample. The inner loop is vectorized by the compiler
+    float *mean = centroids.data();
+    if (pinned) std::copy(pinned, pinned + d, mean);
+    else {
+        for (int s : S) {
+            const float *v = vectors[s];
+            for (int j = 0; j < d; j++) mean[j] += v[j];
+        }
+        for (int j = 0; j < d; j++) mean[j] /= n;
+    }
+    if (k == 1) return centroids;
+
+    // Farthest-first initialization of the rest of the centroids
+    std::vector<float> min_dist(n);
+    for (int i = 0; i < n; i++) min_dist[i] = vectors.euclidean_distance(mean, S[i]);
+    for (int c = 1; c < k; c++) {
+        int farthest = std::max_element(min_dist.begin(), min_dist.end()) - min_dist.begin();
+        std::copy(vectors[S[farthest]], vectors[S[farthest]] + d, centroids.data() + c * d);
+        for (int i = 0; i < n; i++) {
+            min_dist[i] = std::min(min_dist[i], vectors.euclidean_distance(centroids.data() + c * d, S[i]));
+        }
+    }
+
+    // Lloyd iterations: assign every point to its closest centroid and move each centroid to the mean of its points
+    std::vector<int> assignment(n, -1), cluster_size(k);
+    for (int iteration = 0; iteration < KMEANS_ITERATIONS; iteration++) {
+        bool changed = false;
         for (int i = 0; i < n; i++) {
-            index = std::rand() % Pf_vector.size();
-            Rf[i] = Pf_vector[index];
-            // Remove picked element from vector to ensure that it won't be selected again
-            Pf_vector.erase(Pf_vector.begin() + index);
+            int closest = 0;
+            float min = std::numeric_limits<float>::max();
+            for (int c = 0; c < k; c++) {
+                float dist = vectors.euclidean_distance(centroids.data() + c * d, S[i]);
+                if (dist < min) {
+                    min = dist;
+                    closest = c;
+                }
+            }
+            if (assignment[i] != closest) changed = true;
+            assignment[i] = closest;
         }
+        if (!changed) break;
 
-        // Out of the randomly selected vectors, choose one as medoid
-        index = std::rand() % n;
-        (*M)[f] = Rf[index];
+        std::vector<float> sums(k * d, 0.0);
+        std::fill(cluster_size.begin(), cluster_size.end(), 0);
+        for (int i = 0; i < n; i++) {
+            float *sum = sums.data() + assignment[i] * d;
+            const float *v = vectors[S[i]];
+            for (int j = 0; j < d; j++) sum[j] += v[j];
+            cluster_size[assignment[i]]++;
+        }
+        // Empty clusters keep their previous centroid, and so does a pinned one
+        for (int c = pinned ? 1 : 0; c < k; c++) {
+            if (cluster_size[c] == 0) continue;
+            for (int j = 0; j < d; j++) centroids[c * d + j] = sums[c * d + j] / cluster_size[c];
+        }
+    }
+
+    return centroids;
+}
+
+// Returns up to 'count' start nodes of the filter with points Pf, each one being the point closest to a centroid
+// If 'medoid' is given (not -1), it is the first start node and the centroid of its cluster
+static std::vector<int> filter_start_points(const Vectors &vectors, std::vector<int> Pf_vector, int threshold,
+                                            int count, std::default_random_engine &rng, int medoid = -1) {
+    int size = Pf_vector.size();
+    count = std::min(count, size);
+
+    // Select a random sample of min(max(threshold, count), |Pf|) points with a partial Fisher-Yates shuffle
+    int sample_size = std::min(std::max(threshold, count), size);
+    for (int i = 0; i < sample_size; i++) {
+        std::uniform_int_distribution<int> distribution(i, size - 1);
+        std::swap(Pf_vector[i], Pf_vector[distribution(rng)]);
     }
+    std::vector<int> S(Pf_vector.begin(), Pf_vector.begin() + sample_size);
 
-    delete[] Rf;
+    std::vector<float> centroids = kmeans(vectors, S, count, medoid != -1 ? vectors[medoid] : nullptr);
 
+    // For each centroid, choose the closest (not already chosen) point out of all the points of the filter
+    int d = vectors.dimension();
+    std::vector<int> start_points;
+    if (medoid != -1) start_points.push_back(medoid);
+    for (int c = start_points.size(); c < count; c++) {
+        int closest = -1;
+        float min = std::numeric_limits<float>::max();
+        for (int v : Pf_vector) {
+            float dist = vectors.euclidean_distance(centroids.data() + c * d, v);
+            if (dist < min && std::find(start_points.begin(), start_points.end(), v) == start_points.end()) {
+                min = dist;
+                closest = v;
+            }
+        }
+        start_points.push_back(closest);
+    }
+
+    return start_points;
+}
+
+// Same as find_medoid(), but returns up to 'count' diverse start nodes for every filter
+std::vector<std::vector<int>> *find_start_points(const Vectors &vectors, int threshold, int count, const std::vector<int> *medoids) {
+    ERROR_EXIT(threshold < 1 || count < 1, "Invalid threshold or number of start points")
+    PhaseTimer timer(PHASE_MEDOID);
+
+    // Array M mapping labels to start nodes: index=label, value:start-indexes
+    int num_labels = vectors.num_labels();
+    std::vector<std::vector<int>> *M = new std::vector<std::vector<int>>(num_labels);
+
+    // Filters are independent of each other, so they are processed in parallel. Each filter gets its own random engine
+    unsigned int seed = std::random_device {}();
+    #pragma omp parallel for schedule(dynamic)
+    for (int f = 0; f < num_labels; f++) {
+        if (vectors.postings[f].empty()) continue;
+        std::default_random_engine rng { seed + f };
+        int medoid = medoids && f < (int)medoids->size() ? (*medoids)[f] : -1;
+        (*M)[f] = filter_start_points(vectors, vectors.postings[f], threshold, count, rng, medoid);
+    }
+
+    return M;
+}
+
+// For every filter, returns the start node (medoid) that is used by FilteredVamana and by the queries
+std::vector<int> *find_medoid(const Vectors &vectors, int threshold) {
+    std::vector<std::vector<int>> *start_points = find_start_points(vectors, threshold, 1);
+
+    // Array M mapping labels to start nodes: index=label, value:start-index
+    std::vector<int> *M = new std::vector<int>(start_points->size(), -1);
+    for (size_t f = 0; f < start_points->size(); f++) {
+        if (!(*start_points)[f].empty()) (*M)[f] = (*start_points)[f][0];
+    }
+
+    delete start_points;
     return M;
-}
\ No newline at end of file
+}
+
+// Returns the point closest to the centroid of all the points, regardless of their filters
+int find_global_medoid(const Vectors &vectors, int threshold) {
+    ERROR_EXIT(threshold < 1, "Invalid threshold")
+
+    // Points are gathered from the posting lists, so that deleted points are not considered
+    std::vector<int> P;
+    for (const auto& posting : vectors.postings) {
+        P.insert(P.end(), posting.begin(), posting.end());
+    }
+    // Points with multiple labels are in multiple posting lists
+    std::sort(P.begin(), P.end());
+    P.erase(std::unique(P.begin(), P.end()), P.end());
+    ERROR_EXIT(P.empty(), "There are no points")
+
+    std::default_random_engine rng { std::random_device {}() };
+    return filter_start_points(vectors, std::move(P), threshold, 1, rng)[0];
+}
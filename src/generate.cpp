@@ -0,0 +1,110 @@
+#include <algorithm>    // std::copy(), std::min()
+#include <cmath>        // std::pow()
+#include <fstream>      // std::ofstream
+#include <iostream>     // std::cout
+#include <random>       // std::mt19937_64, distributions
+#include <string>       // std::string
+#include <vector>       // std::vector
+
+#include "parameter_parser.hpp"
+
+// Synthetic datasets in the format of the base and query files the executables read, for scaling benchmarks
+// Points are drawn from gaussian clusters and get a label with Zipf-distributed frequencies and a uniform timestamp
+// in [0, 1]. Files are written one vector at a time, so memory does not grow with their size. The groundtruth of the
+// queries is computed from the written files with ./groundtruth
+
+// ./generate -b synthetic-data.bin -q synthetic-queries.bin -n 1000000 -m 10000
+// ./generate -b synthetic-data.bin -q synthetic-queries.bin -n 10000000 -m 10000 --labels 1000 --zipf 1.2 --query-mix 0.25,0.25,0.25,0.25
+
+// Print a progress message every this many written base vectors
+#define GENERATE_PROGRESS_INTERVAL 10000000
+
+// Writes the values of a random point of a random cluster to 'values'
+static void random_point(const std::vector<float>& centers, int dimension, float spread, std::mt19937_64& rng, \
+                         std::vector<float>& values) {
+    std::uniform_int_distribution<int> cluster_distribution(0, centers.size() / dimension - 1);
+    std::normal_distribution<float> noise(0.0, spread);
+
+    const float *center = centers.data() + (size_t)cluster_distribution(rng) * dimension;
+    for (int j = 0; j < dimension; j++) values[j] = center[j] + noise(rng);
+}
+
+int main(int argc, char *argv[]) {
+    std::string base_file, query_file;
+    long base_vectors_num;
+    int query_vectors_num, dimension = 100, labels = 100, clusters = 100;
+    double zipf = 1.0;
+    float spread = 0.5;
+    std::vector<double> query_mix = {0.5, 0.5, 0, 0};
+    unsigned long seed = 42;
+
+    parse_generate(argc, argv, base_file, query_file, base_vectors_num, query_vectors_num, dimension, labels, zipf, clusters, \
+                   spread, query_mix, seed);
+
+    std::mt19937_64 rng(seed);
+
+    // Cluster centers are standard normal. They are the only state that is kept in memory
+    std::vector<float> centers((size_t)clusters * dimension);
+    std::normal_distribution<float> standard_normal(0.0, 1.0);
+    for (auto& value : centers) value = standard_normal(rng);
+
+    // Label i has frequency proportional to 1 / (i + 1)^zipf
+    std::vector<double> label_weights(labels);
+    for (int i = 0; i < labels; i++) label_weights[i] = 1.0 / std::pow(i + 1, zipf);
+    std::discrete_distribution<int> label_distribution(label_weights.begin(), label_weights.end());
+    std::uniform_real_distribution<float> timestamp_distribution(0.0, 1.0);
+
+    // Base vectors: number of vectors, then for every vector its label, timestamp and values
+    std::ofstream base(base_file, std::ios::binary);
+    if (!base) throw std::runtime_error("Error opening file: " + base_file);
+
+    u_int32_t u_base_vectors_num = base_vectors_num;
+    base.write(reinterpret_cast<const char*>(&u_base_vectors_num), sizeof(u_base_vectors_num));
+    std::vector<float> record(2 + dimension);
+    std::vector<float> values(dimension);
+    for (long i = 0; i < base_vectors_num; i++) {
+        record[0] = label_distribution(rng);
+        record[1] = timestamp_distribution(rng);
+        random_point(centers, dimension, spread, rng, values);
+        std::copy(values.begin(), values.end(), record.begin() + 2);
+        base.write(reinterpret_cast<const char*>(record.data()), record.size() * sizeof(float));
+
+        if ((i + 1) % GENERATE_PROGRESS_INTERVAL == 0) std::cout << "Written " << i + 1 << " base vectors" << std::endl;
+    }
+    if (!base) throw std::runtime_error("Error writing file: " + base_file);
+    base.close();
+
+    // Queries: number of queries, then for every query its type, label, timestamp range and values. Unused fields are -1
+    // Type 0 is unfiltered, 1 filtered, 2 has a timestamp range and 3 both a label and a timestamp range
+    std::ofstream queries(query_file, std::ios::binary);
+    if (!queries) throw std::runtime_error("Error opening file: " + query_file);
+
+    u_int32_t u_query_vectors_num = query_vectors_num;
+    queries.write(reinterpret_cast<const char*>(&u_query_vectors_num), sizeof(u_query_vectors_num));
+    std::discrete_distribution<int> type_distribution(query_mix.begin(), query_mix.end());
+    std::vector<float> query(4 + dimension);
+    std::vector<int> type_count(4, 0);
+    for (int i = 0; i < query_vectors_num; i++) {
+        int type = type_distribution(rng);
+        type_count[type]++;
+
+        query[0] = type;
+        query[1] = type == 1 || type == 3 ? label_distribution(rng) : -1;
+        query[2] = query[3] = -1;
+        if (type >= 2) {
+            float from = timestamp_distribution(rng), to = timestamp_distribution(rng);
+            query[2] = std::min(from, to);
+            query[3] = std::max(from, to);
+        }
+        random_point(centers, dimension, spread, rng, values);
+        std::copy(values.begin(), values.end(), query.begin() + 4);
+        queries.write(reinterpret_cast<const char*>(query.data()), query.size() * sizeof(float));
+    }
+    if (!queries) throw std::runtime_error("Error writing file: " + query_file);
+    queries.close();
+
+    std::cout << "Generated " << base_vectors_num << " base vectors and " << query_vectors_num << " queries (" \
+              << type_count[0] << " unfiltered, " << type_count[1] << " filtered, " << type_count[2] << " range, " \
+              << type_count[3] << " filtered range)" << std::endl;
+    return 0;
+}
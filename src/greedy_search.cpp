@@ -3,6 +3,7 @@
 #include <algorithm> 
 #include "utils.hpp"
 #include "greedy_search.hpp"
+#include "stats.hpp"
 
 std::pair<std::vector<int>, std::set<std::pair<float, int>>> 
 GreedySearch(DirectedGraph& graph, Vectors& vectors, int *Pf, int n, int start, int query, int k, int L, int limit) {
@@ -13,11 +14,13 @@ GreedySearch(DirectedGraph& graph, Vectors& vectors, int *Pf, int n, int start,
 
     // Start with the initial node distance
     L_set.insert({vectors.euclidean_distance(Pf[query], Pf[start]), start});  
+    STATS_ADD(insertions, 1);
   
     // Main search loop
     while (--limit) {
         // Find first unvisited node in L_set
         auto p_star = std::find_if(L_set.begin(), L_set.end(), [&](const auto& pair) {
+            STATS_ADD(visited, 1);
             return !visited[pair.second];
         });
         if (p_star == L_set.end()) {
@@ -25,15 +28,19 @@ GreedySearch(DirectedGraph& graph, Vectors& vectors, int *Pf, int n, int start,
         }
         
         visited[p_star->second] = true;
+        STATS_ADD(visited, 1);
+        STATS_ADD(expansions, 1);
 
         // Insert neighbors with distances
         const auto& neighbors = graph.get_neighbors(p_star->second);
         for (auto neighbor : neighbors) {
             L_set.insert({vectors.euclidean_distance(Pf[query], Pf[neighbor]), neighbor});
         }
+        STATS_ADD(insertions, neighbors.size());
 
         // Restrict L_set to a maximum size of L
         if (L_set.size() > static_cast<unsigned long int>(L)) {
+            STATS_ADD(evictions, L_set.size() - L);
             auto it = L_set.end();
             std::advance(it, -(L_set.size() - L));
             L_set.erase(it, L_set.end());
@@ -48,6 +55,7 @@ GreedySearch(DirectedGraph& graph, Vectors& vectors, int *Pf, int n, int start,
     }
 
     // Add the deleted visited indeces to L_set
+    STATS_ADD(visited, n);
     for (int i = 0; i < n; i++) {
         if (visited[i]) {
             L_set.insert({vectors.euclidean_distance(Pf[query], Pf[i]), i});
@@ -14,6 +14,9 @@ std::vector<int> get_true_knn_unfiltered(Vectors &vectors, int data_vecs_num, in
 
     // Calculate euclidean distance from query vector to every single data vector
     for (int i = 0 ; i < data_vecs_num ; i++) {
+        // Ignore vectors out of the query's timestamp range
+        if (!vectors.in_range(data_vecs_num + query_index, i)) continue;
+
         float dist = vectors.euclidean_distance(data_vecs_num + query_index, i);
         std::pair<float, int> p(dist, i);
         s.insert(p);
@@ -35,15 +38,13 @@ std::vector<int> get_true_knn_unfiltered(Vectors &vectors, int data_vecs_num, in
 
 // Returns the true top k nearest neighbors for unfiltered queries
 std::vector<int> get_true_knn_filtered(Vectors &vectors, int data_vecs_num, int query_index) {
-    float query_filter = vectors.filters[data_vecs_num + query_index];
     // Save the pair (euclidean distance, index) of all neighbors in ascending euclidean distance
     std::set<std::pair<float, int>> s;
 
     // Calculate euclidean distance from query vector to every single data vector
     for (int i = 0 ; i < data_vecs_num ; i++) {
-        // Ignore vectors with different filters
-        float current_filter = vectors.filters[i];
-        if (query_filter != current_filter) continue;
+        // Ignore vectors without a common filter or out of the query's timestamp range
+        if (!vectors.same_filter(data_vecs_num + query_index, i) || !vectors.in_range(data_vecs_num + query_index, i)) continue;
 
         float dist = vectors.euclidean_distance(data_vecs_num + query_index, i);
         std::pair<float, int> p(dist, i);
@@ -65,12 +66,21 @@ std::vector<int> get_true_knn_filtered(Vectors &vectors, int data_vecs_num, int
 }
 
 // ./groundtruth ./dummy/dummy-data.bin ./dummy/dummy-queries.bin ./dummy/dummy-groundtruth.bin
+// ./groundtruth ./dummy/dummy-data.bin ./dummy/dummy-queries.bin ./range-groundtruth.bin --ranges
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <data vectors> <query vectors> <groundtruth filename>" << std::endl;
+    if (argc < 4 || argc > 6) {
+        std::cerr << "Usage: " << argv[0] << " <data vectors> <query vectors> <groundtruth filename> [<extra labels file>] [--ranges]" << std::endl;
         exit(EXIT_FAILURE);
     }
 
+    // With --ranges, timestamp queries (types 2 and 3) are answered as well
+    std::string labels_file = "";
+    bool range_flag = false;
+    for (int i = 4; i < argc; i++) {
+        if (std::string(argv[i]) == "--ranges") range_flag = true;
+        else labels_file = argv[i];
+    }
+
     // Read number of data vectors
     u_int32_t u_data_vecs_num;
     std::ifstream data_file(argv[1], std::ios::binary);
@@ -88,7 +98,9 @@ int main(int argc, char *argv[]) {
     // Use vector constructor for euclidean distances
     // NOTE: Vector constructor doesn't save queries that contain timestamp in order to maximize spatial effiency
     Vectors vectors(argv[1], VEC_DIMENSION, data_vecs_num, query_vecs_num);
-    vectors.read_queries(argv[2], query_vecs_num);
+    // Labels that only the sidecar file has must exist before the queries that filter on them are read
+    if (!labels_file.empty()) vectors.read_labels(labels_file);
+    vectors.read_queries(argv[2], query_vecs_num, range_flag);
 
     std::cout << "Reading queries..." << std::endl;
 
@@ -100,8 +112,8 @@ int main(int argc, char *argv[]) {
     for (int i = 0 ; i < query_vecs_num ; i++) {
         std::vector<float> buff(104);
         queries_file.read((char *)buff.data(), 104 * sizeof(float));
-        if (buff[0] == 0) index_of[i] = {valid_queries_count++, false};
-        else if (buff[0] == 1) index_of[i] = {valid_queries_count++, true};
+        if (buff[0] == 0 || (buff[0] == 2 && range_flag)) index_of[i] = {valid_queries_count++, false};
+        else if (buff[0] == 1 || (buff[0] == 3 && range_flag)) index_of[i] = {valid_queries_count++, true};
         else index_of[i] = {-1, false};
     }
     queries_file.close();
@@ -0,0 +1,101 @@
+#include <cstdint>              // uintptr_t, uint64_t
+#include <cstdlib>              // std::calloc(), std::free()
+#include <cstring>              // std::memset()
+#include <fstream>              // std::ifstream
+#include <linux/perf_event.h>   // perf_event_attr
+#include <sstream>              // std::istringstream
+#include <string>               // std::string
+#include <sys/mman.h>           // mmap(), munmap(), madvise()
+#include <sys/syscall.h>        // SYS_perf_event_open
+#include <unistd.h>             // syscall(), read(), close()
+
+#include "huge_pages.hpp"
+
+static bool huge_pages = false;
+
+// Helper function to round 'bytes' up to a multiple of the huge page size
+static size_t round_up(size_t bytes) {
+    return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+void set_huge_pages(bool enable) {
+    huge_pages = enable;
+}
+
+bool huge_pages_enabled() {
+    return huge_pages;
+}
+
+void *huge_alloc(size_t bytes, PageBacking *backing) {
+    if (backing) *backing = PageBacking::NORMAL;
+    if (bytes < HUGE_PAGE_SIZE) return std::calloc(bytes ? bytes : 1, 1);
+
+    size_t length = round_up(bytes);
+    if (huge_pages) {
+        // Fails unless enough pages have been reserved in the pool (vm.nr_hugepages)
+        void *memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            if (backing) *backing = PageBacking::HUGETLB;
+            return memory;
+        }
+    }
+
+    // Map one more huge page than needed and unmap the parts before and after an aligned region, since transparent huge
+    // pages only back the aligned 2 MB ranges of a mapping
+    void *mapping = mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return nullptr;
+
+    char *start = static_cast<char*>(mapping);
+    size_t head = (HUGE_PAGE_SIZE - reinterpret_cast<uintptr_t>(start) % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    if (head) munmap(start, head);
+    munmap(start + head + length, HUGE_PAGE_SIZE - head);
+    start += head;
+
+    if (huge_pages && madvise(start, length, MADV_HUGEPAGE) == 0 && backing) *backing = PageBacking::TRANSPARENT;
+    return start;
+}
+
+void huge_free(void *memory, size_t bytes) {
+    if (memory == nullptr) return;
+    if (bytes < HUGE_PAGE_SIZE) std::free(memory);
+    else munmap(memory, round_up(bytes));
+}
+
+long huge_page_bytes() {
+    std::ifstream file("/proc/self/smaps_rollup");
+    if (!file) return -1;
+
+    // Sizes are given in kB
+    long kilobytes = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string name;
+        long size;
+        if (!(fields >> name >> size)) continue;
+        if (name == "AnonHugePages:" || name == "Private_Hugetlb:" || name == "Shared_Hugetlb:") kilobytes += size;
+    }
+    return kilobytes * 1024;
+}
+
+TlbMissCounter::TlbMissCounter() {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    // Misses of the kernel may not be counted by unprivileged processes
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+TlbMissCounter::~TlbMissCounter() {
+    if (fd != -1) close(fd);
+}
+
+long TlbMissCounter::read() const {
+    uint64_t count;
+    if (fd == -1 || ::read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+    return count;
+}
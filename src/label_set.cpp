@@ -0,0 +1,93 @@
+#include <algorithm>
+
+#include "label_set.hpp"
+
+// Add 'label' to the set
+void LabelSet::insert(Label label) {
+    // A label that does not fit in the bitmap turns the set into a sorted array
+    if (bitmap && label >= LABEL_BITMAP_BITS) {
+        data = labels();
+        bitmap = false;
+    }
+
+    if (bitmap) {
+        if (label / 32 >= data.size()) data.resize(label / 32 + 1, 0);
+        data[label / 32] |= 1u << (label % 32);
+    } else {
+        auto it = std::lower_bound(data.begin(), data.end(), label);
+        if (it == data.end() || *it != label) data.insert(it, label);
+    }
+}
+
+// Returns true if 'label' is in the set
+bool LabelSet::contains(Label label) const {
+    if (!bitmap) return std::binary_search(data.begin(), data.end(), label);
+    return label / 32 < data.size() && (data[label / 32] >> (label % 32)) & 1;
+}
+
+// Number of labels in the set
+int LabelSet::size() const {
+    if (!bitmap) return data.size();
+
+    int count = 0;
+    for (auto word : data) count += __builtin_popcount(word);
+    return count;
+}
+
+// Returns the labels of the set in ascending order
+std::vector<Label> LabelSet::labels() const {
+    if (!bitmap) return data;
+
+    std::vector<Label> result;
+    for (size_t i = 0; i < data.size(); i++) {
+        for (uint32_t word = data[i]; word; word &= word - 1) {
+            result.push_back(i * 32 + __builtin_ctz(word));
+        }
+    }
+    return result;
+}
+
+// Predicates for sets that are (at least one of them) sorted arrays. They run for every neighbor a filtered search or
+// prune checks, so labels are read in place: two arrays are merged, else the labels of an array are probed in the
+// bitmap (or the labels of this set in the other sets)
+bool LabelSet::slow_intersects(const LabelSet& other) const {
+    if (!bitmap && !other.bitmap) {
+        for (size_t i = 0, j = 0; i < data.size() && j < other.data.size(); ) {
+            if (data[i] == other.data[j]) return true;
+            if (data[i] < other.data[j]) i++;
+            else j++;
+        }
+        return false;
+    }
+
+    const LabelSet& array = bitmap ? other : *this;
+    const LabelSet& probed = bitmap ? *this : other;
+    return !array.all_labels([&probed](Label label) { return !probed.contains(label); });
+}
+
+bool LabelSet::slow_subset_of(const LabelSet& other) const {
+    if (!bitmap && !other.bitmap) return std::includes(other.data.begin(), other.data.end(), data.begin(), data.end());
+    return all_labels([&other](Label label) { return other.contains(label); });
+}
+
+bool LabelSet::slow_common_subset_of(const LabelSet& other, const LabelSet& cover) const {
+    if (!bitmap && !other.bitmap) {
+        for (size_t i = 0, j = 0; i < data.size() && j < other.data.size(); ) {
+            if (data[i] == other.data[j]) {
+                if (!cover.contains(data[i])) return false;
+                i++;
+                j++;
+            } else if (data[i] < other.data[j]) {
+                i++;
+            } else {
+                j++;
+            }
+        }
+        return true;
+    }
+
+    // The common labels are the same whichever of the two sets is walked
+    const LabelSet& walked = !other.bitmap ? other : *this;
+    const LabelSet& probed = !other.bitmap ? *this : other;
+    return walked.all_labels([&](Label label) { return !probed.contains(label) || cover.contains(label); });
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+
+#include "latency.hpp"
+
+#define SUB_BUCKETS (1L << LATENCY_SUB_BUCKET_BITS)
+
+// Bucket of latency 'value'. Values below SUB_BUCKETS have a bucket each, larger values are bucketed by their highest
+// LATENCY_SUB_BUCKET_BITS + 1 bits
+static int bucket_of(long value) {
+    if (value < SUB_BUCKETS) return value;
+
+    int shift = 63 - __builtin_clzl(value) - LATENCY_SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS + (value >> shift) - SUB_BUCKETS;
+}
+
+// Largest latency of 'bucket'
+static long bucket_end(int bucket) {
+    if (bucket < SUB_BUCKETS) return bucket;
+
+    int shift = bucket / SUB_BUCKETS - 1;
+    long lowest = (bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    return lowest + (1L << shift) - 1;
+}
+
+LatencyHistogram::LatencyHistogram() : counts(64 * SUB_BUCKETS, 0) {}
+
+// Record a latency of 'value' microseconds
+void LatencyHistogram::record(long value) {
+    if (value < 0) value = 0;
+    counts[bucket_of(value)]++;
+    total++;
+    sum += value;
+    max_value = std::max(max_value, value);
+}
+
+// Add the latencies of 'other' to this histogram
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < counts.size(); i++) counts[i] += other.counts[i];
+    total += other.total;
+    sum += other.sum;
+    max_value = std::max(max_value, other.max_value);
+}
+
+// Returns the p-th percentile of the recorded latencies, i.e. the end of the bucket of the ceil(p% * count)-th latency
+long LatencyHistogram::percentile(double p) const {
+    if (total == 0) return 0;
+
+    long rank = std::max(1L, (long)std::ceil(p / 100 * total));
+    long seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(bucket_end(i), max_value);
+    }
+    return max_value;
+}
+
+LatencyRecorder::LatencyRecorder() : histograms(omp_get_max_threads()) {}
+
+// Record the latency of a query of the current thread. Every thread only updates its own histogram, so no locking is needed
+void LatencyRecorder::record(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t thread = omp_get_thread_num();
+    if (thread < histograms.size()) {
+        histograms[thread].record(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
+}
+
+// Returns the latencies of all threads
+LatencyHistogram LatencyRecorder::merged() const {
+    LatencyHistogram result;
+    for (const auto& histogram : histograms) result.merge(histogram);
+    return result;
+}
+
+// Print p50, p90, p99, p99.9 and max latency, and the queries per second over 'seconds' of wall time
+void LatencyRecorder::print(const std::string& title, double seconds) const {
+    LatencyHistogram latencies = merged();
+
+    std::cout << title << " latency (us) with " << histograms.size() << " threads: p50 " << latencies.percentile(50) \
+              << ", p90 " << latencies.percentile(90) << ", p99 " << latencies.percentile(99) << ", p99.9 " \
+              << latencies.percentile(99.9) << ", max " << latencies.max() << std::endl;
+    std::cout << title << " QPS: " << (seconds > 0 ? latencies.count() / seconds : 0) << std::endl;
+}
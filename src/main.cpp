@@ -5,17 +5,27 @@
 #include <chrono>       // For high-resolution clock
 #include <cstdlib>      // srand()
 #include <ctime>        // time()
+#include <fstream>      // std::ifstream
 #include <iostream>     // std::cout
 #include <string>       // std::string
 #include <iterator>
 
+#include "build_profile.hpp"
 #include "directed_graph.hpp"
+#include "disk_index.hpp"
 #include "filtered_greedy_search.hpp"
 #include "filtered_vamana.hpp"
 #include "stitched_vamana.hpp"
 #include "findmedoid.hpp"
+#include "huge_pages.hpp"
+#include "latency.hpp"
+#include "numa_placement.hpp"
 #include "parameter_parser.hpp"
+#include "query_planner.hpp"
+#include "query_stream.hpp"
+#include "range_search.hpp"
 #include "robust_prune.hpp"
+#include "stats.hpp"
 #include "utils.hpp"
 #include "vamana.hpp"
 #include "vectors.hpp"
@@ -25,6 +35,11 @@
 // time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
 // time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -s vamana.bin -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
 // time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin -s new.bin -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
+// time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin --insert new-data.bin -s new.bin -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
+// time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -v vamana.bin --delete deleted.bin -s new.bin -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
+// time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin --labels labels.bin -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
+// time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g range-groundtruth.bin --ranges -n 10000 -m 10000 -a 1.1 -L 150 -R 12 -t 50 -i -1
+// time ./filtered -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin --query-chunk 1000 -n 10000 -m 5012 -a 1.1 -L 150 -R 12 -t 50 -i -1
 
 // time ./stitched -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -n 10000 -m 5012 -a 1.1 -L 150 -l 100 -r 32 -R 64 -t 50 -i -1
 // time ./stitched -b dummy/dummy-data.bin -q dummy/dummy-queries.bin -g dummy/dummy-groundtruth.bin -s vamana.bin -n 10000 -m 5012 -a 1.1 -L 150 -l 100 -r 32 -R 64 -t 50 -i -1
@@ -46,59 +61,86 @@ int intersect(const std::vector<int>& vec1, const std::vector<int>& vec2) {
     return count;
 }
 
-// Calculate recall of current filtered query
-float calculate_filtered_recall(float filter, std::unordered_map<float, int> *M, DirectedGraph *g, Vectors& vectors, int j, int base_vectors_num, int L, std::string groundtruth_file) {
-    std::vector<int> L_set;
-    int start = M->at(filter);
-    L_set = FilteredGreedySearch(*g, vectors, start, j + base_vectors_num, K, L, std::numeric_limits<int>::max()).first;
+// Helper function to read a binary file of vector indexes (number of indexes followed by the indexes)
+std::vector<int> read_indexes(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
 
+    u_int32_t count = 0;
+    file.read(reinterpret_cast<char *>(&count), sizeof(count));
+    std::vector<int> indexes(count);
+    if (!file.read(reinterpret_cast<char *>(indexes.data()), count * sizeof(int))) {
+        throw std::runtime_error("Error reading indexes from file");
+    }
+    return indexes;
+}
+
+// Helper function to return the recall of the result of query 'j', compared to its groundtruth
+float calculate_recall(Vectors& vectors, const std::vector<int>& result, int j, std::string groundtruth_file) {
     auto groundtruth = vectors.query_solutions(groundtruth_file, j);
     std::sort(groundtruth.begin(), groundtruth.end());
     while (!groundtruth.empty() && groundtruth[0] == -1) groundtruth.erase(groundtruth.begin());
     int groundtruth_count = groundtruth.size();
 
-    int common_count = intersect(groundtruth, L_set);
+    // Range queries may have no points in their range, in which case there is nothing to find
+    if (groundtruth_count == 0) return 1.0;
+
+    int common_count = intersect(groundtruth, result);
 
     return float(common_count) / groundtruth_count;
 }
 
+// The current query is stored at 'query' in 'vectors' and 'j' is its number in the groundtruth file
+
+// Calculate recall of current filtered query, answered with the given plan
+// Only the search is timed in 'latencies', not reading its groundtruth
+float calculate_filtered_recall(const std::vector<int>& starts, QueryPlan plan, int L_factor, const SearchTermination& termination, DirectedGraph *g, Vectors& vectors, int query, int j, int L, std::string groundtruth_file, LatencyRecorder& latencies) {
+    auto search_start = std::chrono::steady_clock::now();
+    std::vector<int> L_set = FilteredSearch(*g, vectors, starts, query, K, L, plan, L_factor, termination);
+    latencies.record(search_start);
+
+    return calculate_recall(vectors, L_set, j, groundtruth_file);
+}
+
 // Calculate recall of current unfiltered query
-float calculate_unfiltered_recall(std::unordered_map<float, int> *M, DirectedGraph *g, Vectors& vectors, int j, int base_vectors_num, int L, std::string groundtruth_file, int limit) {
-    std::vector<int> L_set;
+// The search is seeded with the 'num_entry_points' entry points closest to the query (all of them if 0), nearest first
+float calculate_unfiltered_recall(const std::vector<int>& entry_points, int num_entry_points, DirectedGraph *g, Vectors& vectors, int query, int j, int L, std::string groundtruth_file, int limit, const SearchTermination& termination, LatencyRecorder& latencies) {
+    auto search_start = std::chrono::steady_clock::now();
+    std::vector<int> starts = nearest_entry_points(entry_points, num_entry_points, vectors, query);
 
-    std::set<std::pair<float, int>> all_medoids_knn;
-    for (auto pair : *M) {
-        auto set = FilteredGreedySearch(*g, vectors, pair.second, j + base_vectors_num, K, L, limit).second;
+    std::vector<int> L_set = UnfilteredGreedySearch(*g, vectors, starts, query, K, L, limit, termination).first;
+    latencies.record(search_start);
 
-        auto start = set.begin();
-        auto end = set.begin();
-        std::advance(end, std::min(K, static_cast<int>(set.size()))); 
-        all_medoids_knn.insert(start, end);
-    }
+    return calculate_recall(vectors, L_set, j, groundtruth_file);
+}
 
-    auto it = all_medoids_knn.begin();
-    for (int i = 0; i < K && it != all_medoids_knn.end(); i++, it++) {
-        L_set.push_back(it->second);
-    }
-    
-    auto groundtruth = vectors.query_solutions(groundtruth_file, j);
-    std::sort(groundtruth.begin(), groundtruth.end());
-    while (!groundtruth.empty() && groundtruth[0] == -1) groundtruth.erase(groundtruth.begin());
-    int groundtruth_count = groundtruth.size();
+// Calculate recall of current range query. Filtered range queries are seeded with 'filter_starts', the start nodes of
+// their labels, and unfiltered ones with the nearest entry points
+float calculate_range_recall(const std::vector<int>& filter_starts, const std::vector<int>& entry_points, int num_entry_points, DirectedGraph *g, Vectors& vectors, int query, int j, int L, std::string groundtruth_file, int limit, int range_threshold, LatencyRecorder& latencies) {
+    auto search_start = std::chrono::steady_clock::now();
+    const LabelSet& filter = vectors.filters[query];
+    std::vector<int> starts = filter.empty() ? nearest_entry_points(entry_points, num_entry_points, vectors, query) : filter_starts;
 
-    int common_count = intersect(groundtruth, L_set);
+    std::vector<int> L_set = RangeSearch(*g, vectors, starts, query, K, L, limit, range_threshold);
+    latencies.record(search_start);
 
-    return float(common_count) / groundtruth_count;
+    return calculate_recall(vectors, L_set, j, groundtruth_file);
 }
 
 int main(int argc, char *argv[]) {
     srand(time(NULL));  // Seed for randomization
 
     // Common command line parameters
-    std::string base_file, query_file, groundtruth_file, vamana_file = "", save_file = "";
+    std::string base_file, query_file, groundtruth_file, vamana_file = "", save_file = "", insert_file = "", \
+                delete_file = "", labels_file = "", disk_file = "";
     int base_vectors_num, query_vectors_num, L, t, index, limit = std::numeric_limits<int>::max();
-    float a;
-    bool random_graph_flag = false;
+    float a, consolidate_threshold = CONSOLIDATE_THRESHOLD;
+    bool random_graph_flag = false, global_medoid_flag = false, range_flag = false, pca_flag = false, pin_threads_flag = false, \
+         interleave_flag = false, huge_pages_flag = false;
+    int entry_points = 0, entry_candidates = 1, range_threshold = RANGE_BRUTE_FORCE_THRESHOLD;
+    int brute_force_threshold = PLANNER_BRUTE_FORCE_THRESHOLD, large_L_threshold = PLANNER_LARGE_L_THRESHOLD, \
+        L_factor = PLANNER_L_FACTOR, query_chunk = 0;
+    SearchTermination termination;     // Early termination of the searches, off by default
 
     // Extra parameter for filtered Vamana
     int R;
@@ -111,90 +153,258 @@ int main(int argc, char *argv[]) {
     // Parse command line arguements differently for each executable
     #ifdef FILTERED_VAMANA
     parse_filtered(VEC_DIMENSION, K, argc, argv, base_file, query_file, groundtruth_file, vamana_file, save_file, \
-                   base_vectors_num, query_vectors_num, a, L, t, index, R, random_graph_flag, limit);
+                   base_vectors_num, query_vectors_num, a, L, t, index, R, random_graph_flag, limit, insert_file, delete_file, \
+                   consolidate_threshold, entry_points, global_medoid_flag, labels_file, range_flag, range_threshold, \
+                   brute_force_threshold, large_L_threshold, L_factor, query_chunk, disk_file, entry_candidates, termination, pca_flag, \
+                   pin_threads_flag, interleave_flag, huge_pages_flag);
     #else
     parse_stitched(VEC_DIMENSION, K, argc, argv, base_file, query_file, groundtruth_file, vamana_file, save_file, base_vectors_num, \
                    query_vectors_num, a, L, t, index, L_small, R_small, R_stitched, \
-                   random_graph_flag, random_medoid_flag, random_subset_medoid_flag, limit);
+                   random_graph_flag, random_medoid_flag, random_subset_medoid_flag, limit, insert_file, delete_file, \
+                   consolidate_threshold, entry_points, global_medoid_flag, labels_file, range_flag, range_threshold, \
+                   brute_force_threshold, large_L_threshold, L_factor, query_chunk, disk_file, entry_candidates, termination, pca_flag, \
+                   pin_threads_flag, interleave_flag, huge_pages_flag);
     #endif
 
-    // Load base and queries vectors
-    Vectors vectors(base_file, VEC_DIMENSION, base_vectors_num, query_vectors_num);
-    vectors.read_queries(query_file, query_vectors_num);
+    // Threads are pinned before the pool is used. The vectors and the graph are interleaved across the NUMA nodes while
+    // they are loaded and built, so that no node serves all of their accesses
+    if (pin_threads_flag) std::cout << "Pinned " << pin_threads() << " threads" << std::endl;
+    if (interleave_flag && !interleave_memory(true)) std::cout << "Memory interleaving is not available (single NUMA node)" << std::endl;
+    // The base vectors are allocated on huge pages, if they are available, from now on
+    set_huge_pages(huge_pages_flag);
+
+    // Load base vectors. Queries are read after the build, 'query_chunk' of them at a time (all at once by default)
+    if (query_chunk == 0 || query_chunk > query_vectors_num) query_chunk = query_vectors_num;
+    Vectors vectors(base_file, VEC_DIMENSION, base_vectors_num, query_chunk);
+    if (!labels_file.empty()) vectors.read_labels(labels_file);
+    // Distances do not change, so the graph and the groundtruth are the same with the rotated vectors
+    if (pca_flag) vectors.pca_rotate();
 
     // Start timer for build time
     std::cout << "Building..." << std::endl;
     auto build_start = std::chrono::steady_clock::now();
 
-    DirectedGraph *g;
-    std::unordered_map<float, int> *M = find_medoid(vectors, t);
+    DirectedGraph *g = nullptr;
     // If user gave vamana file, use it to initialize the graph
-    if (!vamana_file.empty()) g = read_vamana_from_file(vamana_file);
+    if (!vamana_file.empty()) {
+        g = read_vamana_from_file(vamana_file);
+        ERROR_EXIT(g->get_size() != vectors.size(), "Vamana file does not match the number of base vectors")
+
+        // Freed vertices of a loaded graph hold no point, so they must not be chosen as start nodes
+        for (auto v : g->get_free_vertices()) vectors.remove_posting(v);
+    }
+
+    std::vector<int> *M = find_medoid(vectors, t);
     // Else, initialize graph g with FilteredVamana or StitchedVamana accordingly for each executable
     #ifdef FILTERED_VAMANA
-    else g = filtered_vamana(vectors, a, L, R, M, random_graph_flag, limit);
+    if (g == nullptr) g = filtered_vamana(vectors, a, L, R, M, random_graph_flag, limit);
     #else
-    else g = stitched_vamana(vectors, a, L_small, R_small, R_stitched, random_graph_flag, random_medoid_flag, random_subset_medoid_flag, limit);
+    if (g == nullptr) g = stitched_vamana(vectors, a, L_small, R_small, R_stitched, random_graph_flag, random_medoid_flag, random_subset_medoid_flag, limit);
+    // Insertions and deletions keep the degree limit of the stitched graph
+    R = R_stitched;
     #endif
 
+    // If user gave a file with vectors to delete, tombstone them. Searches still traverse them but never return them
+    // The tombstones (with the ones of the loaded graph) are consolidated once they reach the threshold, before the
+    // insertions, so that the freed slots are reused
+    if (!delete_file.empty()) {
+        size_t tombstones = g->get_tombstones().size();
+        for (auto v : read_indexes(delete_file)) g->mark_deleted(v);
+        std::cout << "Deleted " << g->get_tombstones().size() - tombstones << " vectors" << std::endl;
+    }
+    if (!g->get_tombstones().empty()) {
+        int consolidated = filtered_lazy_consolidate(g, vectors, a, R, M, consolidate_threshold);
+        if (consolidated > 0) std::cout << "Consolidated " << consolidated << " deleted vectors" << std::endl;
+        else std::cout << g->get_tombstones().size() << " deleted vectors are not consolidated yet" << std::endl;
+    }
+
+    // If user gave a file with new vectors, link them into the loaded graph instead of rebuilding it
+    if (!insert_file.empty()) {
+        int inserted = filtered_insert_from_file(g, vectors, insert_file, a, L, R, M, limit);
+        std::cout << "Inserted " << inserted << " vectors" << std::endl;
+
+        // Queries are stored right after the (possibly grown) base vectors
+        base_vectors_num = vectors.size();
+    }
+
+    // Memory of the queries is allocated on the node of the thread that answers them
+    if (interleave_flag) interleave_memory(false);
+    if (huge_pages_flag) std::cout << huge_page_bytes() / double(1 << 20) << " MB backed by huge pages" << std::endl;
+
     // End timer for build time
-    std::cout << "Build time: " << elapsed_time(build_start) << " seconds" << std::endl << std::endl;
+    float build_time = elapsed_time(build_start);
+    std::cout << "Build time: " << build_time << " seconds" << std::endl << std::endl;
+    build_profile.print(build_time);
+    STATS_PRINT(build_stats, "Build (per insertion)");
+
+    // Unfiltered queries are seeded with the start nodes of all filters (and optionally the global medoid)
+    std::vector<int> unfiltered_entry_points;
+    for (int start : *M) {
+        if (start != -1) unfiltered_entry_points.push_back(start);
+    }
+    int global_medoid = global_medoid_flag ? find_global_medoid(vectors, t) : -1;
+    if (global_medoid != -1) unfiltered_entry_points.push_back(global_medoid);
+
+    // With several start node candidates per label, every label contributes its candidate closest to the query
+    // instead of its medoid, so searches skip the hops from the center of the label toward the query. The medoids the
+    // graph was built from are among the candidates
+    std::vector<std::vector<int>> *start_points = nullptr;
+    if (entry_candidates > 1) {
+        start_points = find_start_points(vectors, std::max(t, PLANNER_ENTRY_SAMPLE * entry_candidates), entry_candidates, M);
+    }
+    auto filter_starts = [&](int query) {
+        const LabelSet& filter = vectors.filters[query];
+        return start_points ? closest_start_nodes(filter, *start_points, vectors, query) : filter_start_nodes(filter, M);
+    };
+    auto query_entry_points = [&](int query) {
+        if (!start_points) return unfiltered_entry_points;
+        std::vector<int> starts = closest_start_nodes(LabelSet(), *start_points, vectors, query);
+        if (global_medoid != -1) starts.push_back(global_medoid);
+        return starts;
+    };
+
+    // Range queries look up the points of their range in the timestamp index
+    if (range_flag) vectors.build_time_index();
 
     // Start timer for total query time
     std::cout << "Querying..." << std::endl;
     auto total_query_start = std::chrono::steady_clock::now();
 
+    // Queries are searched a chunk at a time, while the next chunk is read
+    QueryStream queries(query_file, VEC_DIMENSION, query_vectors_num, query_chunk, range_flag);
+
     // User wants to calculate total recall
     if (index == -1) {
-        int count = 0, filtered_count = 0, unfiltered_count = 0;
-        float recall_sum = 0.0, filtered_recall_sum = 0.0, unfiltered_recall_sum = 0.0;
-        
-        // Filtered Queries
-        auto filtered_queries_start = std::chrono::steady_clock::now();
-        #pragma omp parallel for reduction(+: recall_sum, count, filtered_recall_sum, filtered_count)
-        for (int j = 0; j < query_vectors_num; j++) {
-            float filter = vectors.filters[j + base_vectors_num];
-            if (filter == -1 || M->find(filter) == M->end()) continue;
-            
-            float current_recall = calculate_filtered_recall(filter, M, g, vectors, j, base_vectors_num, L, groundtruth_file);
-            
-            // These updates are part of the reduction
-            count++;
-            recall_sum += current_recall;
-            filtered_count++;
-            filtered_recall_sum += current_recall;
+        int count = 0, filtered_count = 0, unfiltered_count = 0, range_count = 0;
+        float recall_sum = 0.0, filtered_recall_sum = 0.0, unfiltered_recall_sum = 0.0, range_recall_sum = 0.0;
+        float filtered_queries_time = 0.0, unfiltered_queries_time = 0.0, range_queries_time = 0.0;
+        int brute_force_count = 0, large_L_count = 0, graph_count = 0;
+        StatsCollector filtered_stats, unfiltered_stats, range_stats;
+        LatencyRecorder filtered_latencies, unfiltered_latencies, range_latencies;
+
+        for (int loaded = queries.next(vectors); loaded > 0; loaded = queries.next(vectors)) {
+            int first = queries.first();
+
+            // Filtered Queries
+            auto filtered_queries_start = std::chrono::steady_clock::now();
+            #pragma omp parallel for reduction(+: recall_sum, count, filtered_recall_sum, filtered_count, brute_force_count, large_L_count, graph_count)
+            for (int i = 0; i < loaded; i++) {
+                int query = i + base_vectors_num;
+                const LabelSet& filter = vectors.filters[query];
+                if (filter.empty() || vectors.query_range(query).bounded()) continue;
+                std::vector<int> starts = filter_starts(query);
+                if (starts.empty()) continue;
+
+                QueryPlan plan = plan_filtered_query(vectors, query, brute_force_threshold, large_L_threshold);
+                if (plan == PLAN_BRUTE_FORCE) brute_force_count++;
+                else if (plan == PLAN_GRAPH_LARGE_L) large_L_count++;
+                else graph_count++;
+                
+                STATS_BEGIN(filtered_stats);
+                float current_recall = calculate_filtered_recall(starts, plan, L_factor, termination, g, vectors, query, first + i, L, groundtruth_file, filtered_latencies);
+                STATS_END(filtered_stats);
+                
+                // These updates are part of the reduction
+                count++;
+                recall_sum += current_recall;
+                filtered_count++;
+                filtered_recall_sum += current_recall;
+            }
+            filtered_queries_time += elapsed_time(filtered_queries_start);
+
+            // Unfiltered Queries
+            auto unfiltered_queries_start = std::chrono::steady_clock::now();
+            #pragma omp parallel for reduction(+: recall_sum, count, unfiltered_recall_sum, unfiltered_count)
+            for (int i = 0; i < loaded; i++) {
+                int query = i + base_vectors_num;
+                if (!vectors.filters[query].empty() || vectors.query_range(query).bounded()) continue;
+                
+                STATS_BEGIN(unfiltered_stats);
+                float current_recall = calculate_unfiltered_recall(query_entry_points(query), entry_points, g, vectors, query, first + i, L, groundtruth_file, limit, termination, unfiltered_latencies);
+                STATS_END(unfiltered_stats);
+                
+                // These updates are part of the reduction
+                count++;
+                recall_sum += current_recall;
+                unfiltered_count++;
+                unfiltered_recall_sum += current_recall;
+            }
+            unfiltered_queries_time += elapsed_time(unfiltered_queries_start);
+
+            // Range Queries (only loaded if asked)
+            if (!range_flag) continue;
+            auto range_queries_start = std::chrono::steady_clock::now();
+            #pragma omp parallel for reduction(+: recall_sum, count, range_recall_sum, range_count)
+            for (int i = 0; i < loaded; i++) {
+                int query = i + base_vectors_num;
+                if (!vectors.query_range(query).bounded()) continue;
+                std::vector<int> starts = vectors.filters[query].empty() ? std::vector<int>() : filter_starts(query);
+                if (!vectors.filters[query].empty() && starts.empty()) continue;
+
+                STATS_BEGIN(range_stats);
+                float current_recall = calculate_range_recall(starts, query_entry_points(query), entry_points, g, vectors, query, first + i, L, groundtruth_file, limit, range_threshold, range_latencies);
+                STATS_END(range_stats);
+
+                // These updates are part of the reduction
+                count++;
+                recall_sum += current_recall;
+                range_count++;
+                range_recall_sum += current_recall;
+            }
+            range_queries_time += elapsed_time(range_queries_start);
         }
-        std::cout << "Filtered queries time: " << elapsed_time(filtered_queries_start) << std::endl;
-        std::cout << "Filtered queries recall: " << 100*filtered_recall_sum/filtered_count << "%" << std::endl << std::endl;
-
-        // Unfiltered Queries
-        auto unfiltered_queries_start = std::chrono::steady_clock::now();
-        #pragma omp parallel for reduction(+: recall_sum, count, unfiltered_recall_sum, unfiltered_count)
-        for (int j = 0; j < query_vectors_num; j++) {
-            float filter = vectors.filters[j + base_vectors_num];
-            if (filter != -1) continue;
-            
-            float current_recall = calculate_unfiltered_recall(M, g, vectors, j, base_vectors_num, L, groundtruth_file, limit);
-            
-            // These updates are part of the reduction
-            count++;
-            recall_sum += current_recall;
-            unfiltered_count++;
-            unfiltered_recall_sum += current_recall;
+
+        std::cout << "Filtered queries time: " << filtered_queries_time << std::endl;
+        std::cout << "Filtered queries recall: " << 100*filtered_recall_sum/filtered_count << "%" << std::endl;
+        std::cout << "Filtered queries plans: " << brute_force_count << " brute force, " << large_L_count << " graph with L = " \
+                  << L * L_factor << ", " << graph_count << " graph with L = " << L << std::endl;
+        filtered_latencies.print("Filtered queries", filtered_queries_time);
+        std::cout << std::endl;
+        STATS_PRINT(filtered_stats, "Filtered queries");
+
+        std::cout << "Unfiltered queries time: " << unfiltered_queries_time << std::endl;
+        std::cout << "Unfiltered queries recall: " << 100*unfiltered_recall_sum/unfiltered_count << "%" << std::endl;
+        unfiltered_latencies.print("Unfiltered queries", unfiltered_queries_time);
+        std::cout << std::endl;
+        STATS_PRINT(unfiltered_stats, "Unfiltered queries");
+
+        if (range_flag) {
+            std::cout << "Range queries time: " << range_queries_time << std::endl;
+            std::cout << "Range queries recall: " << 100*range_recall_sum/range_count << "%" << std::endl;
+            range_latencies.print("Range queries", range_queries_time);
+            std::cout << std::endl;
+            STATS_PRINT(range_stats, "Range queries");
         }
-        std::cout << "Unfiltered queries time: " << elapsed_time(unfiltered_queries_start) << std::endl;
-        std::cout << "Unfiltered queries recall: " << 100*unfiltered_recall_sum/unfiltered_count << "%" << std::endl << std::endl;
 
         std::cout << "Calculated recall from " << count << " queries" << std::endl;
         std::cout << "Total Recall Percent: " << 100*recall_sum/count << "%" << std::endl << std::endl;
     } else {
-        float filter = vectors.filters[index + base_vectors_num];
-        if (filter != -1 && M->find(filter) == M->end()) std::cout << "This query's filter does not match with any filter of the base vectors" << std::endl;;
+        // Read chunks until the one with the query
+        int loaded;
+        while ((loaded = queries.next(vectors)) > 0 && index >= queries.first() + loaded);
+        if (loaded == 0) {
+            std::cout << "The query file has fewer queries than the query index" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        int query = index - queries.first() + base_vectors_num;
+
+        const LabelSet& filter = vectors.filters[query];
+        std::vector<int> starts = filter_starts(query);
+        if (!filter.empty() && starts.empty()) {
+            std::cout << "This query's filter does not match with any filter of the base vectors" << std::endl;
+            exit(EXIT_FAILURE);
+        }
         
         float current_recall;
-        if (filter != -1) current_recall = calculate_filtered_recall(filter, M, g, vectors, index, base_vectors_num, L, groundtruth_file);
-        else current_recall = calculate_unfiltered_recall(M, g, vectors, index, base_vectors_num, L, groundtruth_file, limit);
+        LatencyRecorder latencies;
+        if (vectors.query_range(query).bounded()) current_recall = calculate_range_recall(starts, query_entry_points(query), entry_points, g, vectors, query, index, L, groundtruth_file, limit, range_threshold, latencies);
+        else if (!filter.empty()) {
+            QueryPlan plan = plan_filtered_query(vectors, query, brute_force_threshold, large_L_threshold);
+            current_recall = calculate_filtered_recall(starts, plan, L_factor, termination, g, vectors, query, index, L, groundtruth_file, latencies);
+        }
+        else current_recall = calculate_unfiltered_recall(query_entry_points(query), entry_points, g, vectors, query, index, L, groundtruth_file, limit, termination, latencies);
         std::cout << "Current recall is: " << 100*current_recall << "%" << std::endl;
+        std::cout << "Current query latency: " << latencies.merged().max() << " us" << std::endl;
     }
 
     // End timer for total query time
@@ -202,8 +412,11 @@ int main(int argc, char *argv[]) {
 
     // Check if user wants to save the graph
     if (!save_file.empty()) write_vamana_to_file(*g, save_file);
+    // Or to save it as a disk index, which ./disk_search searches with little memory
+    if (!disk_file.empty()) write_disk_index(*g, vectors, M, disk_file);
 
     delete M;
+    delete start_points;
     delete g;
     return 0;
 }
@@ -0,0 +1,285 @@
+#include <chrono>       // For high-resolution clock
+#include <cstdio>       // std::remove()
+#include <cstdlib>      // rand()
+#include <fstream>      // std::ofstream
+#include <iomanip>      // std::setw()
+#include <iostream>     // std::cout
+#include <set>          // std::set
+#include <string>       // std::string
+#include <vector>       // std::vector
+#include <x86intrin.h>  // __rdtsc()
+
+#include "compressed_graph.hpp"
+#include "directed_graph.hpp"
+#include "huge_pages.hpp"
+#include "robust_prune.hpp"
+#include "vectors.hpp"
+
+// Microbenchmarks of the primitives that searches and builds are made of, each measured in isolation
+// Warm runs repeat the operation over a small working set that stays in cache. Cold runs evict the caches before every
+// operation (by writing a buffer larger than the last level cache) and pick random inputs
+// bytes/op is the payload an operation has to read (vector values and neighbor indexes), not measured memory traffic
+
+// ./microbench
+// ./microbench 100000 1000
+// ./microbench 1000000 1000000
+
+// Size of the buffer written to evict the caches before cold operations
+#define EVICT_BYTES (64 << 20)
+// Number of inputs that warm runs cycle through
+#define WARM_SET 16
+
+// Dimensions of the distance benchmarks. 100 is the dimension of the dataset, the rest are common embedding sizes
+static const int DIMENSIONS[] = {16, 64, 100, 128, 256, 960};
+// Sizes of the candidate lists of the robust prune benchmarks
+static const int PRUNE_SIZES[] = {50, 100, 150};
+
+// Keeps results alive, so that the measured operations are not optimized away
+static volatile float sink;
+static std::vector<char> evict_buffer(EVICT_BYTES);
+
+// Evict (most of) the caches by writing a buffer larger than them
+static void evict_caches() {
+    for (size_t i = 0; i < evict_buffer.size(); i += 64) evict_buffer[i]++;
+}
+
+// Time and cycles of a number of operations
+struct Measurement {
+    double ns = 0;
+    double cycles = 0;
+    long ops = 0;
+};
+
+// Measure 'ops' calls of 'op(i)', with i = 0, 1, ..., ops-1
+// Cold operations are measured one at a time, after evicting the caches, which is not part of the measurement
+template <typename Op>
+static Measurement measure(long ops, bool cold, Op op) {
+    Measurement m;
+    if (!cold) {
+        // Run once untimed, so that the working set is in cache
+        for (long i = 0; i < WARM_SET; i++) op(i);
+
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long start_cycles = __rdtsc();
+        for (long i = 0; i < ops; i++) op(i);
+        m.cycles = __rdtsc() - start_cycles;
+        m.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    } else {
+        for (long i = 0; i < ops; i++) {
+            evict_caches();
+
+            auto start = std::chrono::steady_clock::now();
+            unsigned long long start_cycles = __rdtsc();
+            op(i);
+            m.cycles += __rdtsc() - start_cycles;
+            m.ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+    m.ops = ops;
+    return m;
+}
+
+// Print one row of the results table
+static void print_row(const std::string& name, bool cold, const Measurement& m, double bytes) {
+    std::cout << std::left << std::setw(40) << name << std::setw(6) << (cold ? "cold" : "warm") << std::right << std::fixed \
+              << std::setprecision(1) << std::setw(14) << m.ns / m.ops << std::setw(14) << m.cycles / m.ops \
+              << std::setw(12) << std::setprecision(0) << bytes << std::endl;
+}
+
+// Create 'count' random vectors of 'dimension' values, by writing them to a temporary file in the dataset format
+// (number of vectors, then for each vector its label, timestamp and values) and loading it
+static Vectors *random_vectors(int count, int dimension, int labels) {
+    std::string file_name = "microbench-" + std::to_string(dimension) + ".bin";
+    std::ofstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    u_int32_t u_count = count;
+    file.write(reinterpret_cast<const char*>(&u_count), sizeof(u_count));
+    std::vector<float> values(dimension);
+    for (int i = 0; i < count; i++) {
+        float label = rand() % labels, timestamp = (float)rand() / RAND_MAX;
+        for (auto& value : values) value = (float)rand() / RAND_MAX;
+        file.write(reinterpret_cast<const char*>(&label), sizeof(label));
+        file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+        file.write(reinterpret_cast<const char*>(values.data()), dimension * sizeof(float));
+    }
+    file.close();
+
+    Vectors *vectors = new Vectors(file_name, dimension, count, 0);
+    std::remove(file_name.c_str());
+    return vectors;
+}
+
+// Vectors::euclidean_distance() between two base vectors, for every dimension
+static void bench_distances(int points, long ops) {
+    for (int dimension : DIMENSIONS) {
+        Vectors *vectors = random_vectors(points, dimension, 1);
+        std::vector<int> a(ops), b(ops);
+        for (long i = 0; i < ops; i++) {
+            a[i] = rand() % points;
+            b[i] = rand() % points;
+        }
+
+        std::string name = "euclidean_distance (d = " + std::to_string(dimension) + ")";
+        double bytes = 2.0 * dimension * sizeof(float);
+        for (bool cold : {false, true}) {
+            // Warm runs cycle through WARM_SET pairs, cold runs through random pairs
+            Measurement m = measure(cold ? ops / 10 : ops * 10, cold, [&](long i) {
+                long j = cold ? i : i % WARM_SET;
+                sink = sink + vectors->euclidean_distance(a[j], b[j]);
+            });
+            print_row(name, cold, m, bytes);
+        }
+        delete vectors;
+    }
+}
+
+// Graph with 'R' random out-neighbors per vertex
+static DirectedGraph *random_graph(int points, int R) {
+    DirectedGraph *graph = new DirectedGraph(points);
+    for (int i = 0; i < points; i++) {
+        while ((int)graph->get_neighbors(i).size() < R) {
+            int j = rand() % points;
+            if (j != i) graph->insert(i, j);
+        }
+    }
+    return graph;
+}
+
+// Iteration over the out-neighbors of a vertex, one hop of greedy search and robust prune, on a random graph
+static void bench_graph(int points, long ops) {
+    const int R = 32, dimension = 100;
+    Vectors *vectors = random_vectors(points, dimension, 1);
+    DirectedGraph *graph = random_graph(points, R);
+    std::vector<int> Pf(points);
+    for (int i = 0; i < points; i++) Pf[i] = i;
+
+    std::vector<int> nodes(ops);
+    for (long i = 0; i < ops; i++) nodes[i] = rand() % points;
+
+    // Sum the indexes of the out-neighbors of a vertex
+    for (bool cold : {false, true}) {
+        Measurement m = measure(cold ? ops / 10 : ops * 10, cold, [&](long i) {
+            int sum = 0;
+            for (auto neighbor : graph->get_neighbors(nodes[cold ? i : i % WARM_SET])) sum += neighbor;
+            sink = sink + sum;
+        });
+        print_row("get_neighbors iteration (R = " + std::to_string(R) + ")", cold, m, R * sizeof(int));
+    }
+
+    // The same over the compressed neighbor lists, which are decoded on every call
+    CompressedGraph compressed(*graph);
+    for (bool cold : {false, true}) {
+        Measurement m = measure(cold ? ops / 10 : ops * 10, cold, [&](long i) {
+            int sum = 0;
+            for (auto neighbor : compressed.get_neighbors(nodes[cold ? i : i % WARM_SET])) sum += neighbor;
+            sink = sink + sum;
+        });
+        print_row("compressed get_neighbors (R = " + std::to_string(R) + ")", cold, m, \
+                  double(compressed.memory()) / points);
+    }
+
+    // The body of one GreedySearch() iteration: the distances of the query to the out-neighbors of the expanded node are
+    // inserted to a candidate set of L points, which is then trimmed back to L
+    const int L = 100;
+    for (bool cold : {false, true}) {
+        std::set<std::pair<float, int>> L_set;
+        for (int i = 0; i < L; i++) L_set.insert({(float)i, rand() % points});
+
+        Measurement m = measure(cold ? ops / 10 : ops, cold, [&](long i) {
+            long j = cold ? i : i % WARM_SET;
+            int query = nodes[(j + 1) % ops];
+            for (auto neighbor : graph->get_neighbors(nodes[j])) {
+                L_set.insert({vectors->euclidean_distance(Pf[query], Pf[neighbor]), neighbor});
+            }
+            auto it = L_set.begin();
+            std::advance(it, L);
+            L_set.erase(it, L_set.end());
+        });
+        sink = sink + L_set.begin()->first;
+        print_row("greedy search hop (R = " + std::to_string(R) + ", L = " + std::to_string(L) + ")", cold, m, \
+                  R * (sizeof(int) + dimension * sizeof(float)) + dimension * sizeof(float));
+    }
+
+    // robust_prune() of a vertex over a candidate list of L points (sorted by distance to the vertex)
+    for (int size : PRUNE_SIZES) {
+        std::vector<std::set<std::pair<float, int>>> candidate_lists(WARM_SET);
+        std::vector<int> pruned(WARM_SET);
+        auto make_candidates = [&](int p) {
+            std::set<std::pair<float, int>> V;
+            while ((int)V.size() < size) {
+                int q = rand() % points;
+                if (q != p) V.insert({vectors->euclidean_distance(p, q), q});
+            }
+            return V;
+        };
+        for (int i = 0; i < WARM_SET; i++) {
+            pruned[i] = nodes[i];
+            candidate_lists[i] = make_candidates(pruned[i]);
+        }
+
+        for (bool cold : {false, true}) {
+            long prune_ops = cold ? ops / 100 : ops / 10;
+            Measurement m = measure(prune_ops, cold, [&](long i) {
+                // robust_prune() consumes its candidate list, so copying it is part of the measurement
+                std::set<std::pair<float, int>> V = candidate_lists[i % WARM_SET];
+                robust_prune(graph, *vectors, Pf.data(), pruned[i % WARM_SET], V, 1.2, R);
+            });
+            print_row("robust_prune (|V| = " + std::to_string(size) + ", R = " + std::to_string(R) + ")", cold, m, \
+                      size * dimension * sizeof(float));
+        }
+    }
+
+    delete graph;
+    delete vectors;
+}
+
+// Distances between random pairs of base vectors, with the vectors on normal and then on huge pages (see set_huge_pages())
+// Caches are not evicted, but consecutive pairs lie on unrelated pages, as in searches, so with enough points most of
+// them miss the TLB. Data TLB misses are printed if there is a hardware counter for them
+static void bench_huge_pages(int points, long ops) {
+    const int dimension = 100;
+    std::vector<int> a(ops), b(ops);
+    for (long i = 0; i < ops; i++) {
+        a[i] = rand() % points;
+        b[i] = rand() % points;
+    }
+
+    for (bool huge : {false, true}) {
+        set_huge_pages(huge);
+        Vectors *vectors = random_vectors(points, dimension, 1);
+
+        TlbMissCounter counter;
+        Measurement m = measure(ops, false, [&](long i) {
+            sink = sink + vectors->euclidean_distance(a[i], b[i]);
+        });
+        long misses = counter.read();
+
+        print_row(std::string("random pair distance (") + (huge ? "huge" : "4 KB") + " pages)", false, m, \
+                  2.0 * dimension * sizeof(float));
+        if (misses != -1) std::cout << "    data TLB misses/op: " << double(misses) / ops << std::endl;
+        delete vectors;
+    }
+    set_huge_pages(false);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " [<number of points> [<operations per benchmark>]]" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    int points = argc > 1 ? std::stoi(argv[1]) : 10000;
+    long ops = argc > 2 ? std::stol(argv[2]) : 10000;
+    if (points < 2 * WARM_SET || ops < 100) {
+        std::cerr << "At least " << 2 * WARM_SET << " points and 100 operations are needed" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    srand(0);   // Same inputs on every run, so that runs are comparable
+
+    std::cout << std::left << std::setw(40) << "benchmark" << std::setw(6) << "cache" << std::right << std::setw(14) \
+              << "ns/op" << std::setw(14) << "cycles/op" << std::setw(12) << "bytes/op" << std::endl;
+    bench_distances(points, ops);
+    bench_graph(points, ops);
+    bench_huge_pages(points, ops);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <algorithm>        // std::sort(), std::unique()
+#include <cctype>           // isspace()
+#include <fstream>          // std::ifstream
+#include <linux/mempolicy.h> // MPOL_INTERLEAVE, MPOL_DEFAULT
+#include <omp.h>            // omp_get_thread_num()
+#include <sched.h>          // sched_getaffinity(), sched_setaffinity()
+#include <sstream>          // std::stringstream
+#include <sys/syscall.h>    // SYS_set_mempolicy
+#include <unistd.h>         // syscall()
+
+#include "numa_placement.hpp"
+
+#define NODE_DIR "/sys/devices/system/node/"
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> ids;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), ::isspace), range.end());
+        if (range.empty()) continue;
+
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int id = first; id <= last; id++) ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+// Helper function to read the list in a sysfs file. Returns an empty list if the file cannot be read
+static std::vector<int> read_list(const std::string& file_name) {
+    std::ifstream file(file_name);
+    std::string line;
+    if (!file || !std::getline(file, line)) return {};
+    return parse_cpu_list(line);
+}
+
+// Nodes with memory, the ones that pages can be placed on
+static std::vector<int> memory_nodes() {
+    return read_list(NODE_DIR "has_memory");
+}
+
+std::vector<std::vector<int>> numa_node_cpus() {
+    // CPUs the process may run on (e.g. restricted by taskset or a container)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return {};
+
+    std::vector<std::vector<int>> node_cpus;
+    for (int node : memory_nodes()) {
+        std::vector<int> cpus;
+        for (int cpu : read_list(NODE_DIR "node" + std::to_string(node) + "/cpulist")) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        // Nodes of memory only (or of CPUs that are not allowed) get no threads
+        if (!cpus.empty()) node_cpus.push_back(cpus);
+    }
+
+    if (node_cpus.empty()) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        node_cpus.push_back(cpus);
+    }
+    return node_cpus;
+}
+
+std::vector<int> spread_cpus(const std::vector<std::vector<int>>& node_cpus) {
+    std::vector<int> order;
+    size_t max_cpus = 0;
+    for (const auto& cpus : node_cpus) max_cpus = std::max(max_cpus, cpus.size());
+
+    for (size_t i = 0; i < max_cpus; i++) {
+        for (const auto& cpus : node_cpus) {
+            if (i < cpus.size()) order.push_back(cpus[i]);
+        }
+    }
+    return order;
+}
+
+int pin_threads() {
+    std::vector<int> cpus = spread_cpus(numa_node_cpus());
+    if (cpus.empty()) return 0;
+
+    int pinned = 0;
+    #pragma omp parallel reduction(+: pinned)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[omp_get_thread_num() % cpus.size()], &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) pinned++;
+    }
+    return pinned;
+}
+
+bool interleave_memory(bool interleave) {
+    std::vector<int> nodes = memory_nodes();
+    if (nodes.size() < 2) return false;
+
+    // Bit mask of the nodes. The kernel reads 'maxnode' - 1 bits of it
+    const int bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(nodes.back() / bits + 1, 0);
+    for (int node : nodes) mask[node / bits] |= 1UL << (node % bits);
+    unsigned long maxnode = mask.size() * bits + 1;
+
+    // The memory policy is a property of every thread, so it is set by every thread of the pool
+    int failures = 0;
+    #pragma omp parallel reduction(+: failures)
+    {
+        long result = interleave ? syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, mask.data(), maxnode)
+                                 : syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+        if (result != 0) failures++;
+    }
+    return failures == 0;
+}
@@ -3,6 +3,12 @@
 #include <iostream>
 #include <limits>
 
+#include "disk_index.hpp"       // DISK_BEAM_WIDTH
+#include "filtered_vamana.hpp"  // CONSOLIDATE_THRESHOLD
+#include "parameter_parser.hpp" // SERVE_MAX_BATCH
+#include "query_planner.hpp"    // PLANNER_* defaults
+#include "range_search.hpp"     // RANGE_BRUTE_FORCE_THRESHOLD
+
 // Print usage in cerr
 void print_usage() {
     std::cerr << "Usage: " << std::endl;
@@ -29,6 +35,28 @@ void print_usage() {
     std::cerr << "-s <save file>" << std::endl;
     std::cerr << "--random-graph" << std::endl;
     std::cerr << "--limit <unfiltered queries search limit>" << std::endl;
+    std::cerr << "--insert <new base vectors file> (requires -v)" << std::endl;
+    std::cerr << "--delete <file of vector indexes to delete> (requires -v)" << std::endl;
+    std::cerr << "--consolidate-threshold <fraction of the points that must be deleted before the graph is consolidated> (default: " \
+              << CONSOLIDATE_THRESHOLD << ")" << std::endl;
+    std::cerr << "--entry-points <number of nearest start nodes seeding unfiltered queries> (default: all)" << std::endl;
+    std::cerr << "--entry-candidates <start node candidates per label, the closest to the query is used> (default: 1, the medoid)" << std::endl;
+    std::cerr << "--patience <expansions without improving the k-th best candidate after which a search stops> (default: off)" << std::endl;
+    std::cerr << "--epsilon <a search stops when its closest unexpanded candidate is farther than (1 + epsilon) times the k-th best> (default: off)" << std::endl;
+    std::cerr << "--adaptive-L <initial L of searches that double it until their top k is stable> (default: off)" << std::endl;
+    std::cerr << "--pca (rotate the vectors to their principal components, so that distances are abandoned sooner)" << std::endl;
+    std::cerr << "--pin-threads (pin the threads to CPUs, spread across the NUMA nodes)" << std::endl;
+    std::cerr << "--interleave (interleave the vectors and the graph across the NUMA nodes)" << std::endl;
+    std::cerr << "--huge-pages (back the vectors and the compressed graph with 2 MB pages)" << std::endl;
+    std::cerr << "--global-medoid (also seed unfiltered queries with the medoid of all points)" << std::endl;
+    std::cerr << "--labels <file of extra labels of the base vectors>" << std::endl;
+    std::cerr << "--ranges (also answer timestamp queries, requires a groundtruth file that includes them)" << std::endl;
+    std::cerr << "--range-threshold <max points in range for brute force range queries> (default: " << RANGE_BRUTE_FORCE_THRESHOLD << ")" << std::endl;
+    std::cerr << "--brute-force-threshold <max points of a filter for brute force filtered queries> (default: " << PLANNER_BRUTE_FORCE_THRESHOLD << ")" << std::endl;
+    std::cerr << "--large-L-threshold <max points of a filter for filtered queries with a larger L> (default: " << PLANNER_LARGE_L_THRESHOLD << ")" << std::endl;
+    std::cerr << "--L-factor <factor of L for filtered queries with a larger L> (default: " << PLANNER_L_FACTOR << ")" << std::endl;
+    std::cerr << "--query-chunk <queries read from the query file at a time> (default: all)" << std::endl;
+    std::cerr << "--disk <file to save the graph and the vectors as a disk index>" << std::endl;
     #ifndef FILTERED_VAMANA
     std::cerr << "--random-medoid" << std::endl;
     std::cerr << "--random-subset-medoid" << std::endl;
@@ -38,14 +66,19 @@ void print_usage() {
 // Parse input arguments for FilteredVamana
 void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::string &base_file, std::string &query_file, std::string &groundtruth_file, \
                       std::string &vamana_file, std::string &save_file, int &base_vectors_num, int &query_vectors_num, \
-                      float &a, int &L, int &t, int &index, int &R, bool &random_graph_flag, int &limit) {
+                      float &a, int &L, int &t, int &index, int &R, bool &random_graph_flag, int &limit, std::string &insert_file, \
+                      std::string &delete_file, float &consolidate_threshold, int &entry_points, bool &global_medoid_flag, std::string &labels_file, \
+                      bool &range_flag, int &range_threshold, \
+                      int &brute_force_threshold, int &large_L_threshold, int &L_factor, int &query_chunk, std::string &disk_file, \
+                      int &entry_candidates, SearchTermination &termination, bool &pca_flag, bool &pin_threads_flag, \
+                      bool &interleave_flag, bool &huge_pages_flag) {
     // Common command line mandatory flags
     bool base_file_flag = false, query_file_flag = false, groundtruth_file_flag = false, base_vectors_num_flag = false, \
          query_vectors_num_flag = false, a_flag = false, L_flag = false, t_flag = false, index_flag = false;
     bool R_flag = false;    // Extra mandatory flag for FilteredVamana
          
-    // For FilteredVamana, minimum arguements are 21 and maximum are 28
-    if (argc < 21 || argc > 28) {
+    // For FilteredVamana, minimum arguements are 21 and maximum are 64
+    if (argc < 21 || argc > 64) {
         print_usage();
         exit(EXIT_FAILURE);
     }
@@ -54,6 +87,27 @@ void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::strin
     struct option long_options[] = {
         {"random-graph", no_argument, nullptr, 1},
         {"limit", required_argument, nullptr, 2},
+        {"insert", required_argument, nullptr, 3},
+        {"delete", required_argument, nullptr, 4},
+        {"entry-points", required_argument, nullptr, 5},
+        {"global-medoid", no_argument, nullptr, 6},
+        {"labels", required_argument, nullptr, 7},
+        {"ranges", no_argument, nullptr, 8},
+        {"range-threshold", required_argument, nullptr, 9},
+        {"brute-force-threshold", required_argument, nullptr, 10},
+        {"large-L-threshold", required_argument, nullptr, 11},
+        {"L-factor", required_argument, nullptr, 12},
+        {"query-chunk", required_argument, nullptr, 13},
+        {"disk", required_argument, nullptr, 14},
+        {"entry-candidates", required_argument, nullptr, 15},
+        {"patience", required_argument, nullptr, 16},
+        {"epsilon", required_argument, nullptr, 17},
+        {"adaptive-L", required_argument, nullptr, 18},
+        {"pca", no_argument, nullptr, 19},
+        {"pin-threads", no_argument, nullptr, 20},
+        {"interleave", no_argument, nullptr, 21},
+        {"huge-pages", no_argument, nullptr, 22},
+        {"consolidate-threshold", required_argument, nullptr, 23},
         {nullptr, 0, nullptr, 0}    // Terminating null entry
     };
 
@@ -158,6 +212,125 @@ void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::strin
                 exit(EXIT_FAILURE);
             }
             break;
+        case 3: // Insert new base vectors to a loaded graph
+            insert_file = optarg;
+            if (!std::ifstream(insert_file)) {
+                std::cerr << "Insert file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 4: // Delete vectors from a loaded graph
+            delete_file = optarg;
+            if (!std::ifstream(delete_file)) {
+                std::cerr << "Delete file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 5: // Number of start nodes seeding unfiltered queries
+            entry_points = std::stoi(optarg);
+            if (entry_points <= 0) {
+                std::cerr << "Entry points must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 6: // Seed unfiltered queries with the global medoid as well
+            global_medoid_flag = true;
+            break;
+        case 7: // Extra labels of the base vectors
+            labels_file = optarg;
+            if (!std::ifstream(labels_file)) {
+                std::cerr << "Labels file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 8: // Load timestamp (range) queries as well
+            range_flag = true;
+            break;
+        case 9: // Maximum number of points in range for which range queries use brute force
+            range_threshold = std::stoi(optarg);
+            if (range_threshold < 0) {
+                std::cerr << "Range threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 10: // Maximum number of points of a filtered query's labels for which they are scanned
+            brute_force_threshold = std::stoi(optarg);
+            if (brute_force_threshold < 0) {
+                std::cerr << "Brute force threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 11: // Maximum number of points of a filtered query's labels for which a larger L is used
+            large_L_threshold = std::stoi(optarg);
+            if (large_L_threshold < 0) {
+                std::cerr << "Large L threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 12: // Factor of L for filtered queries with few points
+            L_factor = std::stoi(optarg);
+            if (L_factor < 1) {
+                std::cerr << "L factor must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 13: // Number of queries read from the query file at a time
+            query_chunk = std::stoi(optarg);
+            if (query_chunk < 1) {
+                std::cerr << "Query chunk must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 14: // Disk index file
+            disk_file = optarg;
+            break;
+        case 15: // Start node candidates per label
+            entry_candidates = std::stoi(optarg);
+            if (entry_candidates < 1) {
+                std::cerr << "Entry candidates must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 16: // Expansions without improvement after which a search stops
+            termination.patience = std::stoi(optarg);
+            if (termination.patience < 1) {
+                std::cerr << "Patience must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 17: // Distance factor of unexpanded candidates after which a search stops
+            termination.epsilon = std::stof(optarg);
+            if (termination.epsilon < 0) {
+                std::cerr << "Epsilon must not be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 18: // Initial L of adaptive L searches
+            termination.initial_L = std::stoi(optarg);
+            if (termination.initial_L < 1) {
+                std::cerr << "Initial L must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 19: // Rotate the vectors to their principal components
+            pca_flag = true;
+            break;
+        case 20: // Pin the threads to CPUs
+            pin_threads_flag = true;
+            break;
+        case 21: // Interleave the memory across the NUMA nodes
+            interleave_flag = true;
+            break;
+        case 22: // Back the vectors and the graph with huge pages
+            huge_pages_flag = true;
+            break;
+        case 23: // Fraction of deleted points after which the graph is consolidated
+            consolidate_threshold = std::stof(optarg);
+            if (consolidate_threshold < 0 || consolidate_threshold > 1) {
+                std::cerr << "Consolidate threshold must be between 0 and 1" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
         default:
             print_usage();
             exit(EXIT_FAILURE);
@@ -183,6 +356,21 @@ void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::strin
         exit(EXIT_FAILURE);
     }
 
+    // Insertion and deletion are only possible on an already built graph
+    if (!insert_file.empty() && vamana_file.empty()) {
+        std::cerr << "Flag --insert requires a vamana file (-v)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!delete_file.empty() && vamana_file.empty()) {
+        std::cerr << "Flag --delete requires a vamana file (-v)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // The disk index would hold rotated vectors, while its queries are not rotated
+    if (pca_flag && !disk_file.empty()) {
+        std::cerr << "Flag --pca cannot be combined with --disk" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
     // Output parameters
     std::cout << "-----Parameters-----" << std::endl;
     std::cout << "Base file = " << base_file << std::endl;
@@ -190,6 +378,11 @@ void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::strin
     std::cout << "Groundtruth file = " << groundtruth_file << std::endl;
     std::cout << "Vamana file = " << vamana_file << std::endl;
     std::cout << "Save file = " << save_file << std::endl;
+    if (!disk_file.empty()) std::cout << "Disk index file = " << disk_file << std::endl;
+    if (!insert_file.empty()) std::cout << "Insert file = " << insert_file << std::endl;
+    if (!delete_file.empty()) std::cout << "Delete file = " << delete_file << std::endl;
+    if (!vamana_file.empty()) std::cout << "Consolidate threshold = " << consolidate_threshold << std::endl;
+    if (!labels_file.empty()) std::cout << "Labels file = " << labels_file << std::endl;
     std::cout << "Vector dimension = " << vec_dimension << std::endl;
     std::cout << "k = " << k << std::endl;
     std::cout << "Base vectors number = " << base_vectors_num << std::endl;
@@ -201,6 +394,20 @@ void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::strin
     std::cout << "index = " << index << std::endl;
     if (random_graph_flag) std::cout << "Using random graph for FilteredVamana initialization" << std::endl;
     if (limit != std::numeric_limits<int>::max()) std::cout << "Using limit: " << limit << std::endl;
+    if (entry_points != 0) std::cout << "Using " << entry_points << " entry points for unfiltered queries" << std::endl;
+    if (entry_candidates > 1) std::cout << "Using " << entry_candidates << " start node candidates per label" << std::endl;
+    if (termination.patience > 0) std::cout << "Using search patience: " << termination.patience << std::endl;
+    if (termination.epsilon >= 0) std::cout << "Using search epsilon: " << termination.epsilon << std::endl;
+    if (termination.initial_L > 0) std::cout << "Using adaptive L from " << termination.initial_L << std::endl;
+    if (pca_flag) std::cout << "Using PCA rotation of the vectors" << std::endl;
+    if (pin_threads_flag) std::cout << "Pinning threads to CPUs" << std::endl;
+    if (interleave_flag) std::cout << "Interleaving memory across NUMA nodes" << std::endl;
+    if (huge_pages_flag) std::cout << "Using huge pages" << std::endl;
+    if (global_medoid_flag) std::cout << "Using global medoid for unfiltered queries" << std::endl;
+    if (range_flag) std::cout << "Using range queries with brute force threshold: " << range_threshold << std::endl;
+    std::cout << "Filtered queries brute force threshold = " << brute_force_threshold << std::endl;
+    std::cout << "Filtered queries large L threshold = " << large_L_threshold << " (L factor = " << L_factor << ")" << std::endl;
+    if (query_chunk != 0) std::cout << "Reading queries in chunks of " << query_chunk << std::endl;
     std::cout << std::endl;
 }
 
@@ -208,15 +415,20 @@ void parse_filtered(int vec_dimension, int k, int argc, char *argv[], std::strin
 void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::string &base_file, std::string &query_file, std::string &groundtruth_file, \
                       std::string &vamana_file, std::string &save_file, int &base_vectors_num, int &query_vectors_num, \
                       float &a, int &L, int &t, int &index, int &L_small, int &R_small, int &R_stitched, \
-                      bool &random_graph_flag, bool &random_medoid_flag, bool &random_subset_medoid_flag, int &limit) {
+                      bool &random_graph_flag, bool &random_medoid_flag, bool &random_subset_medoid_flag, int &limit, \
+                      std::string &insert_file, std::string &delete_file, float &consolidate_threshold, int &entry_points, bool &global_medoid_flag, std::string &labels_file, \
+                      bool &range_flag, int &range_threshold, \
+                      int &brute_force_threshold, int &large_L_threshold, int &L_factor, int &query_chunk, std::string &disk_file, \
+                      int &entry_candidates, SearchTermination &termination, bool &pca_flag, bool &pin_threads_flag, \
+                      bool &interleave_flag, bool &huge_pages_flag) {
     // Common command line mandatory flags
     bool base_file_flag = false, query_file_flag = false, groundtruth_file_flag = false, base_vectors_num_flag = false, \
          query_vectors_num_flag = false, a_flag = false, L_flag = false, t_flag = false, index_flag = false;
     bool L_small_flag = false, R_small_flag = false, R_stitched_flag = false;   // Extra mandatory flags for FilteredVamana
          
 
-    // For StitchedVamana, minimum arguements are 25 and maximum are 33
-    if (argc < 25 || argc > 33) {
+    // For StitchedVamana, minimum arguements are 25 and maximum are 69
+    if (argc < 25 || argc > 69) {
         print_usage();
         exit(EXIT_FAILURE);
     }
@@ -227,6 +439,27 @@ void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::strin
         {"random-medoid", no_argument, nullptr, 2},
         {"random-subset-medoid", no_argument, nullptr, 3},
         {"limit", required_argument, nullptr, 4},
+        {"insert", required_argument, nullptr, 5},
+        {"delete", required_argument, nullptr, 6},
+        {"entry-points", required_argument, nullptr, 7},
+        {"global-medoid", no_argument, nullptr, 8},
+        {"labels", required_argument, nullptr, 9},
+        {"ranges", no_argument, nullptr, 10},
+        {"range-threshold", required_argument, nullptr, 11},
+        {"brute-force-threshold", required_argument, nullptr, 12},
+        {"large-L-threshold", required_argument, nullptr, 13},
+        {"L-factor", required_argument, nullptr, 14},
+        {"query-chunk", required_argument, nullptr, 15},
+        {"disk", required_argument, nullptr, 16},
+        {"entry-candidates", required_argument, nullptr, 17},
+        {"patience", required_argument, nullptr, 18},
+        {"epsilon", required_argument, nullptr, 19},
+        {"adaptive-L", required_argument, nullptr, 20},
+        {"pca", no_argument, nullptr, 21},
+        {"pin-threads", no_argument, nullptr, 22},
+        {"interleave", no_argument, nullptr, 23},
+        {"huge-pages", no_argument, nullptr, 24},
+        {"consolidate-threshold", required_argument, nullptr, 25},
         {nullptr, 0, nullptr, 0}    // Terminating null entry
     };
 
@@ -353,6 +586,125 @@ void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::strin
                 exit(EXIT_FAILURE);
             }
             break;
+        case 5: // Insert new base vectors to a loaded graph
+            insert_file = optarg;
+            if (!std::ifstream(insert_file)) {
+                std::cerr << "Insert file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 6: // Delete vectors from a loaded graph
+            delete_file = optarg;
+            if (!std::ifstream(delete_file)) {
+                std::cerr << "Delete file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 7: // Number of start nodes seeding unfiltered queries
+            entry_points = std::stoi(optarg);
+            if (entry_points <= 0) {
+                std::cerr << "Entry points must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 8: // Seed unfiltered queries with the global medoid as well
+            global_medoid_flag = true;
+            break;
+        case 9: // Extra labels of the base vectors
+            labels_file = optarg;
+            if (!std::ifstream(labels_file)) {
+                std::cerr << "Labels file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 10: // Load timestamp (range) queries as well
+            range_flag = true;
+            break;
+        case 11: // Maximum number of points in range for which range queries use brute force
+            range_threshold = std::stoi(optarg);
+            if (range_threshold < 0) {
+                std::cerr << "Range threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 12: // Maximum number of points of a filtered query's labels for which they are scanned
+            brute_force_threshold = std::stoi(optarg);
+            if (brute_force_threshold < 0) {
+                std::cerr << "Brute force threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 13: // Maximum number of points of a filtered query's labels for which a larger L is used
+            large_L_threshold = std::stoi(optarg);
+            if (large_L_threshold < 0) {
+                std::cerr << "Large L threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 14: // Factor of L for filtered queries with few points
+            L_factor = std::stoi(optarg);
+            if (L_factor < 1) {
+                std::cerr << "L factor must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 15: // Number of queries read from the query file at a time
+            query_chunk = std::stoi(optarg);
+            if (query_chunk < 1) {
+                std::cerr << "Query chunk must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 16: // Disk index file
+            disk_file = optarg;
+            break;
+        case 17: // Start node candidates per label
+            entry_candidates = std::stoi(optarg);
+            if (entry_candidates < 1) {
+                std::cerr << "Entry candidates must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 18: // Expansions without improvement after which a search stops
+            termination.patience = std::stoi(optarg);
+            if (termination.patience < 1) {
+                std::cerr << "Patience must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 19: // Distance factor of unexpanded candidates after which a search stops
+            termination.epsilon = std::stof(optarg);
+            if (termination.epsilon < 0) {
+                std::cerr << "Epsilon must not be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 20: // Initial L of adaptive L searches
+            termination.initial_L = std::stoi(optarg);
+            if (termination.initial_L < 1) {
+                std::cerr << "Initial L must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 21: // Rotate the vectors to their principal components
+            pca_flag = true;
+            break;
+        case 22: // Pin the threads to CPUs
+            pin_threads_flag = true;
+            break;
+        case 23: // Interleave the memory across the NUMA nodes
+            interleave_flag = true;
+            break;
+        case 24: // Back the vectors and the graph with huge pages
+            huge_pages_flag = true;
+            break;
+        case 25: // Fraction of deleted points after which the graph is consolidated
+            consolidate_threshold = std::stof(optarg);
+            if (consolidate_threshold < 0 || consolidate_threshold > 1) {
+                std::cerr << "Consolidate threshold must be between 0 and 1" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
         default:
             print_usage();
             exit(EXIT_FAILURE);
@@ -377,6 +729,21 @@ void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::strin
         exit(EXIT_FAILURE);
     }
 
+    // Insertion and deletion are only possible on an already built graph
+    if (!insert_file.empty() && vamana_file.empty()) {
+        std::cerr << "Flag --insert requires a vamana file (-v)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    if (!delete_file.empty() && vamana_file.empty()) {
+        std::cerr << "Flag --delete requires a vamana file (-v)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // The disk index would hold rotated vectors, while its queries are not rotated
+    if (pca_flag && !disk_file.empty()) {
+        std::cerr << "Flag --pca cannot be combined with --disk" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
     // Output parameters
     std::cout << "-----Parameters-----" << std::endl;
     std::cout << "Base file = " << base_file << std::endl;
@@ -384,6 +751,11 @@ void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::strin
     std::cout << "Groundtruth file = " << groundtruth_file << std::endl;
     std::cout << "Vamana file = " << vamana_file << std::endl;
     std::cout << "Save file = " << save_file << std::endl;
+    if (!disk_file.empty()) std::cout << "Disk index file = " << disk_file << std::endl;
+    if (!insert_file.empty()) std::cout << "Insert file = " << insert_file << std::endl;
+    if (!delete_file.empty()) std::cout << "Delete file = " << delete_file << std::endl;
+    if (!vamana_file.empty()) std::cout << "Consolidate threshold = " << consolidate_threshold << std::endl;
+    if (!labels_file.empty()) std::cout << "Labels file = " << labels_file << std::endl;
     std::cout << "Vector dimension = " << vec_dimension << std::endl;
     std::cout << "k = " << k << std::endl;
     std::cout << "Base vectors number = " << base_vectors_num << std::endl;
@@ -399,5 +771,882 @@ void parse_stitched(int vec_dimension, int k, int argc, char *argv[], std::strin
     if (random_medoid_flag) std::cout << "Using random medoid for FindMedoid initialization" << std::endl;
     if (random_subset_medoid_flag) std::cout << "Using a random subset of medoids for FindMedoid initialization" << std::endl;
     if (limit != std::numeric_limits<int>::max()) std::cout << "Using limit: " << limit << std::endl;
+    if (entry_points != 0) std::cout << "Using " << entry_points << " entry points for unfiltered queries" << std::endl;
+    if (entry_candidates > 1) std::cout << "Using " << entry_candidates << " start node candidates per label" << std::endl;
+    if (termination.patience > 0) std::cout << "Using search patience: " << termination.patience << std::endl;
+    if (termination.epsilon >= 0) std::cout << "Using search epsilon: " << termination.epsilon << std::endl;
+    if (termination.initial_L > 0) std::cout << "Using adaptive L from " << termination.initial_L << std::endl;
+    if (pca_flag) std::cout << "Using PCA rotation of the vectors" << std::endl;
+    if (pin_threads_flag) std::cout << "Pinning threads to CPUs" << std::endl;
+    if (interleave_flag) std::cout << "Interleaving memory across NUMA nodes" << std::endl;
+    if (huge_pages_flag) std::cout << "Using huge pages" << std::endl;
+    if (global_medoid_flag) std::cout << "Using global medoid for unfiltered queries" << std::endl;
+    if (range_flag) std::cout << "Using range queries with brute force threshold: " << range_threshold << std::endl;
+    std::cout << "Filtered queries brute force threshold = " << brute_force_threshold << std::endl;
+    std::cout << "Filtered queries large L threshold = " << large_L_threshold << " (L factor = " << L_factor << ")" << std::endl;
+    if (query_chunk != 0) std::cout << "Reading queries in chunks of " << query_chunk << std::endl;
+    std::cout << std::endl;
+}
+// Print usage of the benchmark in cerr
+void print_bench_usage() {
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << "---MANDATORY FLAGS---" << std::endl;
+    std::cerr << "-b <base file>" << std::endl;
+    std::cerr << "-q <query file>" << std::endl;
+    std::cerr << "-g <groundtruth file>" << std::endl;
+    std::cerr << "-v <vamana file>" << std::endl;
+    std::cerr << "-n <base vectors number>" << std::endl;
+    std::cerr << "-m <query vectors number>" << std::endl;
+    std::cerr << "-t <tau>" << std::endl;
+
+    std::cerr << "---OPTIONAL FLAGS---" << std::endl;
+    std::cerr << "-L <comma separated L values> (default: 50,100,150,200)" << std::endl;
+    std::cerr << "-k <comma separated k values> (default: 10)" << std::endl;
+    std::cerr << "-T <comma separated thread counts> (default: all threads)" << std::endl;
+    std::cerr << "-f <output format: csv or json> (default: csv)" << std::endl;
+    std::cerr << "-o <output file> (default: standard output)" << std::endl;
+    std::cerr << "--labels <file of extra labels of the base vectors>" << std::endl;
+    std::cerr << "--limit <unfiltered queries search limit>" << std::endl;
+    std::cerr << "--entry-points <number of nearest start nodes seeding unfiltered queries> (default: all)" << std::endl;
+    std::cerr << "--entry-candidates <start node candidates per label, the closest to the query is used> (default: 1, the medoid)" << std::endl;
+    std::cerr << "--patience <expansions without improving the k-th best candidate after which a search stops> (default: off)" << std::endl;
+    std::cerr << "--epsilon <a search stops when its closest unexpanded candidate is farther than (1 + epsilon) times the k-th best> (default: off)" << std::endl;
+    std::cerr << "--adaptive-L <initial L of searches that double it until their top k is stable> (default: off)" << std::endl;
+    std::cerr << "--pca (rotate the vectors to their principal components, so that distances are abandoned sooner)" << std::endl;
+    std::cerr << "--pin-threads (pin the threads to CPUs, spread across the NUMA nodes)" << std::endl;
+    std::cerr << "--interleave (interleave the vectors and the graph across the NUMA nodes)" << std::endl;
+    std::cerr << "--huge-pages (back the vectors and the compressed graph with 2 MB pages)" << std::endl;
+    std::cerr << "--global-medoid (also seed unfiltered queries with the medoid of all points)" << std::endl;
+    std::cerr << "--brute-force-threshold <max points of a filter for brute force filtered queries> (default: " << PLANNER_BRUTE_FORCE_THRESHOLD << ")" << std::endl;
+    std::cerr << "--large-L-threshold <max points of a filter for filtered queries with a larger L> (default: " << PLANNER_LARGE_L_THRESHOLD << ")" << std::endl;
+    std::cerr << "--L-factor <factor of L for filtered queries with a larger L> (default: " << PLANNER_L_FACTOR << ")" << std::endl;
+    std::cerr << "--compressed (also run the sweep on the graph with compressed neighbor lists)" << std::endl;
+}
+
+// Parse a comma separated list of positive integers. 'name' is used in the error message
+static std::vector<int> parse_list(const std::string& list, const std::string& name) {
+    std::vector<int> values;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+
+        int value = std::stoi(list.substr(start, end - start));
+        if (value <= 0) {
+            std::cerr << name << " values must be positive" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        values.push_back(value);
+        start = end + 1;
+    }
+    return values;
+}
+
+// Helper function to print a list of values separated by commas
+static void print_list(const std::vector<int>& values) {
+    for (size_t i = 0; i < values.size(); i++) std::cout << (i ? "," : "") << values[i];
     std::cout << std::endl;
-}
\ No newline at end of file
+}
+
+// Parse input arguments for the benchmark of a saved graph
+void parse_bench(int vec_dimension, int max_k, int argc, char *argv[], std::string &base_file, std::string &query_file, \
+                 std::string &groundtruth_file, std::string &vamana_file, std::string &output_file, std::string &format, \
+                 int &base_vectors_num, int &query_vectors_num, int &t, std::vector<int> &L_values, std::vector<int> &k_values, \
+                 std::vector<int> &thread_counts, std::string &labels_file, int &limit, int &entry_points, bool &global_medoid_flag, \
+                 int &brute_force_threshold, int &large_L_threshold, int &L_factor, bool &compressed_flag, int &entry_candidates, \
+                 SearchTermination &termination, bool &pca_flag, bool &pin_threads_flag, bool &interleave_flag, \
+                 bool &huge_pages_flag) {
+    // Mandatory flags
+    bool base_file_flag = false, query_file_flag = false, groundtruth_file_flag = false, vamana_file_flag = false, \
+         base_vectors_num_flag = false, query_vectors_num_flag = false, t_flag = false;
+
+    // For the benchmark, minimum arguements are 15
+    if (argc < 15) {
+        print_bench_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Define long options
+    struct option long_options[] = {
+        {"labels", required_argument, nullptr, 1},
+        {"limit", required_argument, nullptr, 2},
+        {"entry-points", required_argument, nullptr, 3},
+        {"global-medoid", no_argument, nullptr, 4},
+        {"brute-force-threshold", required_argument, nullptr, 5},
+        {"large-L-threshold", required_argument, nullptr, 6},
+        {"L-factor", required_argument, nullptr, 7},
+        {"compressed", no_argument, nullptr, 8},
+        {"entry-candidates", required_argument, nullptr, 9},
+        {"patience", required_argument, nullptr, 10},
+        {"epsilon", required_argument, nullptr, 11},
+        {"adaptive-L", required_argument, nullptr, 12},
+        {"pca", no_argument, nullptr, 13},
+        {"pin-threads", no_argument, nullptr, 14},
+        {"interleave", no_argument, nullptr, 15},
+        {"huge-pages", no_argument, nullptr, 16},
+        {nullptr, 0, nullptr, 0}    // Terminating null entry
+    };
+
+    // Parse arguments using getopt
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:q:g:v:o:f:n:m:t:L:k:T:", long_options, nullptr)) != -1) {
+        switch (opt) {
+        case 'b': // Base vectors file
+            base_file = optarg;
+            if (!std::ifstream(base_file)) {
+                std::cerr << "Base vectors file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            base_file_flag = true;
+            break;
+        case 'q': // Query vectors file
+            query_file = optarg;
+            if (!std::ifstream(query_file)) {
+                std::cerr << "Query vectors file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            query_file_flag = true;
+            break;
+        case 'g': // Groundtruth vectors file
+            groundtruth_file = optarg;
+            if (!std::ifstream(groundtruth_file)) {
+                std::cerr << "Groundtruth file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            groundtruth_file_flag = true;
+            break;
+        case 'v': // Vamana graph file
+            vamana_file = optarg;
+            if (!std::ifstream(vamana_file)) {
+                std::cerr << "Vamana file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            vamana_file_flag = true;
+            break;
+        case 'o': // Output file
+            output_file = optarg;
+            break;
+        case 'f': // Output format
+            format = optarg;
+            if (format != "csv" && format != "json") {
+                std::cerr << "Output format must be csv or json" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'n': // Number of base vectors
+            base_vectors_num = std::stoi(optarg);
+            if (base_vectors_num <= 0) {
+                std::cerr << "Base vectors number must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            base_vectors_num_flag = true;
+            break;
+        case 'm': // Number of query vectors
+            query_vectors_num = std::stoi(optarg);
+            if (query_vectors_num <= 0) {
+                std::cerr << "Query vectors number must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            query_vectors_num_flag = true;
+            break;
+        case 't': // Tau for FindMedoid()
+            t = std::stoi(optarg);
+            if (t < 1) {
+                std::cerr << "Tau must be greater than 0" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            t_flag = true;
+            break;
+        case 'L': // Swept greedy search limits L
+            L_values = parse_list(optarg, "L");
+            break;
+        case 'k': // Swept numbers of nearest neighbors k
+            k_values = parse_list(optarg, "k");
+            for (int k : k_values) {
+                if (k > max_k) {
+                    std::cerr << "k cannot be larger than the groundtruth size (" << max_k << ")" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+        case 'T': // Swept thread counts
+            thread_counts = parse_list(optarg, "Thread count");
+            break;
+        case 1: // Extra labels of the base vectors
+            labels_file = optarg;
+            if (!std::ifstream(labels_file)) {
+                std::cerr << "Labels file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 2: // Set search limit for unfiltered queries
+            limit = std::stoi(optarg);
+            if (limit <= 0) {
+                std::cerr << "limit must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 3: // Number of start nodes seeding unfiltered queries
+            entry_points = std::stoi(optarg);
+            if (entry_points <= 0) {
+                std::cerr << "Entry points must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 4: // Seed unfiltered queries with the global medoid as well
+            global_medoid_flag = true;
+            break;
+        case 5: // Maximum number of points of a filtered query's labels for which they are scanned
+            brute_force_threshold = std::stoi(optarg);
+            if (brute_force_threshold < 0) {
+                std::cerr << "Brute force threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 6: // Maximum number of points of a filtered query's labels for which a larger L is used
+            large_L_threshold = std::stoi(optarg);
+            if (large_L_threshold < 0) {
+                std::cerr << "Large L threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 7: // Factor of L for filtered queries with few points
+            L_factor = std::stoi(optarg);
+            if (L_factor < 1) {
+                std::cerr << "L factor must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 8: // Run the sweep on the compressed graph as well
+            compressed_flag = true;
+            break;
+        case 9: // Start node candidates per label
+            entry_candidates = std::stoi(optarg);
+            if (entry_candidates < 1) {
+                std::cerr << "Entry candidates must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 10: // Expansions without improvement after which a search stops
+            termination.patience = std::stoi(optarg);
+            if (termination.patience < 1) {
+                std::cerr << "Patience must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 11: // Distance factor of unexpanded candidates after which a search stops
+            termination.epsilon = std::stof(optarg);
+            if (termination.epsilon < 0) {
+                std::cerr << "Epsilon must not be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 12: // Initial L of adaptive L searches
+            termination.initial_L = std::stoi(optarg);
+            if (termination.initial_L < 1) {
+                std::cerr << "Initial L must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 13: // Rotate the vectors to their principal components
+            pca_flag = true;
+            break;
+        case 14: // Pin the threads to CPUs
+            pin_threads_flag = true;
+            break;
+        case 15: // Interleave the memory across the NUMA nodes
+            interleave_flag = true;
+            break;
+        case 16: // Back the vectors and the graph with huge pages
+            huge_pages_flag = true;
+            break;
+        default:
+            print_bench_usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Check for unexpected arguments
+    if (optind < argc) {
+        std::cerr << "Error: Unexpected argument \"" << argv[optind] << "\" provided." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Check if all mandatory flags are given
+    if (!base_file_flag || !query_file_flag || !groundtruth_file_flag || !vamana_file_flag || !base_vectors_num_flag \
+        || !query_vectors_num_flag || !t_flag) {
+            print_bench_usage();
+            exit(EXIT_FAILURE);
+        }
+
+    // Output parameters
+    std::cout << "-----Parameters-----" << std::endl;
+    std::cout << "Base file = " << base_file << std::endl;
+    std::cout << "Query file = " << query_file << std::endl;
+    std::cout << "Groundtruth file = " << groundtruth_file << std::endl;
+    std::cout << "Vamana file = " << vamana_file << std::endl;
+    std::cout << "Output file = " << (output_file.empty() ? "standard output" : output_file) << " (" << format << ")" << std::endl;
+    if (!labels_file.empty()) std::cout << "Labels file = " << labels_file << std::endl;
+    std::cout << "Vector dimension = " << vec_dimension << std::endl;
+    std::cout << "Base vectors number = " << base_vectors_num << std::endl;
+    std::cout << "Query vectors number = " << query_vectors_num << std::endl;
+    std::cout << "t = " << t << std::endl;
+    std::cout << "L values = ";
+    print_list(L_values);
+    std::cout << "k values = ";
+    print_list(k_values);
+    std::cout << "Thread counts = ";
+    print_list(thread_counts);
+    if (limit != std::numeric_limits<int>::max()) std::cout << "Using limit: " << limit << std::endl;
+    if (entry_points != 0) std::cout << "Using " << entry_points << " entry points for unfiltered queries" << std::endl;
+    if (entry_candidates > 1) std::cout << "Using " << entry_candidates << " start node candidates per label" << std::endl;
+    if (termination.patience > 0) std::cout << "Using search patience: " << termination.patience << std::endl;
+    if (termination.epsilon >= 0) std::cout << "Using search epsilon: " << termination.epsilon << std::endl;
+    if (termination.initial_L > 0) std::cout << "Using adaptive L from " << termination.initial_L << std::endl;
+    if (pca_flag) std::cout << "Using PCA rotation of the vectors" << std::endl;
+    if (pin_threads_flag) std::cout << "Pinning threads to CPUs" << std::endl;
+    if (interleave_flag) std::cout << "Interleaving memory across NUMA nodes" << std::endl;
+    if (huge_pages_flag) std::cout << "Using huge pages" << std::endl;
+    if (global_medoid_flag) std::cout << "Using global medoid for unfiltered queries" << std::endl;
+    std::cout << "Filtered queries brute force threshold = " << brute_force_threshold << std::endl;
+    std::cout << "Filtered queries large L threshold = " << large_L_threshold << " (L factor = " << L_factor << ")" << std::endl;
+    if (compressed_flag) std::cout << "Comparing with compressed neighbor lists" << std::endl;
+    std::cout << std::endl;
+}
+
+// Print usage of the query server in cerr
+void print_serve_usage() {
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << "---MANDATORY FLAGS---" << std::endl;
+    std::cerr << "-b <base file>" << std::endl;
+    std::cerr << "-v <vamana file>" << std::endl;
+    std::cerr << "-n <base vectors number>" << std::endl;
+    std::cerr << "-t <tau>" << std::endl;
+
+    std::cerr << "---OPTIONAL FLAGS---" << std::endl;
+    std::cerr << "-u <unix domain socket file> (default: standard input and output)" << std::endl;
+    std::cerr << "--max-batch <max requests of a batch> (default: " << SERVE_MAX_BATCH << ")" << std::endl;
+    std::cerr << "--max-connections <max connections of the socket served at once> (default: " << SERVE_MAX_CONNECTIONS << ")" << std::endl;
+    std::cerr << "--cache <max cached results of repeated requests> (default: 0, no cache)" << std::endl;
+    std::cerr << "--labels <file of extra labels of the base vectors>" << std::endl;
+    std::cerr << "--limit <unfiltered queries search limit>" << std::endl;
+    std::cerr << "--entry-points <number of nearest start nodes seeding unfiltered queries> (default: all)" << std::endl;
+    std::cerr << "--entry-candidates <start node candidates per label, the closest to the query is used> (default: 1, the medoid)" << std::endl;
+    std::cerr << "--patience <expansions without improving the k-th best candidate after which a search stops> (default: off)" << std::endl;
+    std::cerr << "--epsilon <a search stops when its closest unexpanded candidate is farther than (1 + epsilon) times the k-th best> (default: off)" << std::endl;
+    std::cerr << "--adaptive-L <initial L of searches that double it until their top k is stable> (default: off)" << std::endl;
+    std::cerr << "--pin-threads (pin the threads to CPUs, spread across the NUMA nodes)" << std::endl;
+    std::cerr << "--interleave (interleave the vectors and the graph across the NUMA nodes)" << std::endl;
+    std::cerr << "--huge-pages (back the vectors and the compressed graph with 2 MB pages)" << std::endl;
+    std::cerr << "--global-medoid (also seed unfiltered queries with the medoid of all points)" << std::endl;
+    std::cerr << "--brute-force-threshold <max points of a filter for brute force filtered queries> (default: " << PLANNER_BRUTE_FORCE_THRESHOLD << ")" << std::endl;
+    std::cerr << "--large-L-threshold <max points of a filter for filtered queries with a larger L> (default: " << PLANNER_LARGE_L_THRESHOLD << ")" << std::endl;
+    std::cerr << "--L-factor <factor of L for filtered queries with a larger L> (default: " << PLANNER_L_FACTOR << ")" << std::endl;
+}
+
+// Parse input arguments for the query server. Parameters are printed in cerr, since cout may carry the responses
+void parse_serve(int vec_dimension, int argc, char *argv[], std::string &base_file, std::string &vamana_file, \
+                 std::string &socket_file, int &base_vectors_num, int &t, int &max_batch, int &max_connections, int &cache_size, \
+                 std::string &labels_file, int &limit, int &entry_points, bool &global_medoid_flag, int &brute_force_threshold, \
+                 int &large_L_threshold, int &L_factor, int &entry_candidates, SearchTermination &termination, \
+                 bool &pin_threads_flag, bool &interleave_flag, bool &huge_pages_flag) {
+    // Mandatory flags
+    bool base_file_flag = false, vamana_file_flag = false, base_vectors_num_flag = false, t_flag = false;
+
+    // For the server, minimum arguements are 9
+    if (argc < 9) {
+        print_serve_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Define long options
+    struct option long_options[] = {
+        {"labels", required_argument, nullptr, 1},
+        {"limit", required_argument, nullptr, 2},
+        {"entry-points", required_argument, nullptr, 3},
+        {"global-medoid", no_argument, nullptr, 4},
+        {"brute-force-threshold", required_argument, nullptr, 5},
+        {"large-L-threshold", required_argument, nullptr, 6},
+        {"L-factor", required_argument, nullptr, 7},
+        {"max-batch", required_argument, nullptr, 8},
+        {"cache", required_argument, nullptr, 9},
+        {"entry-candidates", required_argument, nullptr, 10},
+        {"patience", required_argument, nullptr, 11},
+        {"epsilon", required_argument, nullptr, 12},
+        {"adaptive-L", required_argument, nullptr, 13},
+        {"pin-threads", no_argument, nullptr, 14},
+        {"interleave", no_argument, nullptr, 15},
+        {"huge-pages", no_argument, nullptr, 16},
+        {"max-connections", required_argument, nullptr, 17},
+        {nullptr, 0, nullptr, 0}    // Terminating null entry
+    };
+
+    // Parse arguments using getopt
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:v:n:t:u:", long_options, nullptr)) != -1) {
+        switch (opt) {
+        case 'b': // Base vectors file
+            base_file = optarg;
+            if (!std::ifstream(base_file)) {
+                std::cerr << "Base vectors file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            base_file_flag = true;
+            break;
+        case 'v': // Vamana graph file
+            vamana_file = optarg;
+            if (!std::ifstream(vamana_file)) {
+                std::cerr << "Vamana file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            vamana_file_flag = true;
+            break;
+        case 'n': // Number of base vectors
+            base_vectors_num = std::stoi(optarg);
+            if (base_vectors_num <= 0) {
+                std::cerr << "Base vectors number must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            base_vectors_num_flag = true;
+            break;
+        case 't': // Tau for FindMedoid()
+            t = std::stoi(optarg);
+            if (t < 1) {
+                std::cerr << "Tau must be greater than 0" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            t_flag = true;
+            break;
+        case 'u': // Unix domain socket file
+            socket_file = optarg;
+            break;
+        case 1: // Extra labels of the base vectors
+            labels_file = optarg;
+            if (!std::ifstream(labels_file)) {
+                std::cerr << "Labels file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 2: // Set search limit for unfiltered queries
+            limit = std::stoi(optarg);
+            if (limit <= 0) {
+                std::cerr << "limit must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 3: // Number of start nodes seeding unfiltered queries
+            entry_points = std::stoi(optarg);
+            if (entry_points <= 0) {
+                std::cerr << "Entry points must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 4: // Seed unfiltered queries with the global medoid as well
+            global_medoid_flag = true;
+            break;
+        case 5: // Maximum number of points of a filtered query's labels for which they are scanned
+            brute_force_threshold = std::stoi(optarg);
+            if (brute_force_threshold < 0) {
+                std::cerr << "Brute force threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 6: // Maximum number of points of a filtered query's labels for which a larger L is used
+            large_L_threshold = std::stoi(optarg);
+            if (large_L_threshold < 0) {
+                std::cerr << "Large L threshold cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 7: // Factor of L for filtered queries with few points
+            L_factor = std::stoi(optarg);
+            if (L_factor < 1) {
+                std::cerr << "L factor must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 8: // Maximum number of requests of a batch
+            max_batch = std::stoi(optarg);
+            if (max_batch < 1) {
+                std::cerr << "Max batch must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 9: // Maximum number of cached results
+            cache_size = std::stoi(optarg);
+            if (cache_size < 0) {
+                std::cerr << "Cache size cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 10: // Start node candidates per label
+            entry_candidates = std::stoi(optarg);
+            if (entry_candidates < 1) {
+                std::cerr << "Entry candidates must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 11: // Expansions without improvement after which a search stops
+            termination.patience = std::stoi(optarg);
+            if (termination.patience < 1) {
+                std::cerr << "Patience must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 12: // Distance factor of unexpanded candidates after which a search stops
+            termination.epsilon = std::stof(optarg);
+            if (termination.epsilon < 0) {
+                std::cerr << "Epsilon must not be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 13: // Initial L of adaptive L searches
+            termination.initial_L = std::stoi(optarg);
+            if (termination.initial_L < 1) {
+                std::cerr << "Initial L must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 14: // Pin the threads to CPUs
+            pin_threads_flag = true;
+            break;
+        case 15: // Interleave the memory across the NUMA nodes
+            interleave_flag = true;
+            break;
+        case 16: // Back the vectors and the graph with huge pages
+            huge_pages_flag = true;
+            break;
+        case 17: // Maximum number of connections served at once
+            max_connections = std::stoi(optarg);
+            if (max_connections < 1) {
+                std::cerr << "Max connections must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        default:
+            print_serve_usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Check for unexpected arguments
+    if (optind < argc) {
+        std::cerr << "Error: Unexpected argument \"" << argv[optind] << "\" provided." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Check if all mandatory flags are given
+    if (!base_file_flag || !vamana_file_flag || !base_vectors_num_flag || !t_flag) {
+        print_serve_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Output parameters
+    std::cerr << "-----Parameters-----" << std::endl;
+    std::cerr << "Base file = " << base_file << std::endl;
+    std::cerr << "Vamana file = " << vamana_file << std::endl;
+    std::cerr << "Socket file = " << (socket_file.empty() ? "standard input and output" : socket_file) << std::endl;
+    if (!labels_file.empty()) std::cerr << "Labels file = " << labels_file << std::endl;
+    std::cerr << "Vector dimension = " << vec_dimension << std::endl;
+    std::cerr << "Base vectors number = " << base_vectors_num << std::endl;
+    std::cerr << "t = " << t << std::endl;
+    std::cerr << "Max batch = " << max_batch << std::endl;
+    if (!socket_file.empty()) std::cerr << "Max connections = " << max_connections << std::endl;
+    if (cache_size != 0) std::cerr << "Caching up to " << cache_size << " results" << std::endl;
+    if (limit != std::numeric_limits<int>::max()) std::cerr << "Using limit: " << limit << std::endl;
+    if (entry_points != 0) std::cerr << "Using " << entry_points << " entry points for unfiltered queries" << std::endl;
+    if (entry_candidates > 1) std::cerr << "Using " << entry_candidates << " start node candidates per label" << std::endl;
+    if (termination.patience > 0) std::cerr << "Using search patience: " << termination.patience << std::endl;
+    if (termination.epsilon >= 0) std::cerr << "Using search epsilon: " << termination.epsilon << std::endl;
+    if (termination.initial_L > 0) std::cerr << "Using adaptive L from " << termination.initial_L << std::endl;
+    if (pin_threads_flag) std::cerr << "Pinning threads to CPUs" << std::endl;
+    if (interleave_flag) std::cerr << "Interleaving memory across NUMA nodes" << std::endl;
+    if (huge_pages_flag) std::cerr << "Using huge pages" << std::endl;
+    if (global_medoid_flag) std::cerr << "Using global medoid for unfiltered queries" << std::endl;
+    std::cerr << "Filtered queries brute force threshold = " << brute_force_threshold << std::endl;
+    std::cerr << "Filtered queries large L threshold = " << large_L_threshold << " (L factor = " << L_factor << ")" << std::endl;
+    std::cerr << std::endl;
+}
+
+// Print usage of the disk index search in cerr
+void print_disk_search_usage() {
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << "---MANDATORY FLAGS---" << std::endl;
+    std::cerr << "-d <disk index file>" << std::endl;
+    std::cerr << "-q <query file>" << std::endl;
+    std::cerr << "-g <groundtruth file>" << std::endl;
+    std::cerr << "-m <query vectors number>" << std::endl;
+
+    std::cerr << "---OPTIONAL FLAGS---" << std::endl;
+    std::cerr << "-L <comma separated L values> (default: 50,100,150,200)" << std::endl;
+    std::cerr << "-k <comma separated k values> (default: 10)" << std::endl;
+    std::cerr << "-W <nodes read together in every step> (default: " << DISK_BEAM_WIDTH << ")" << std::endl;
+    std::cerr << "-H (back the codes kept in memory with 2 MB pages)" << std::endl;
+}
+
+void parse_disk_search(int max_k, int argc, char *argv[], std::string &disk_file, std::string &query_file, \
+                       std::string &groundtruth_file, int &query_vectors_num, std::vector<int> &L_values, \
+                       std::vector<int> &k_values, int &beam_width, bool &huge_pages_flag) {
+    // Mandatory flags
+    bool disk_file_flag = false, query_file_flag = false, groundtruth_file_flag = false, query_vectors_num_flag = false;
+
+    // For the disk search, minimum arguements are 9
+    if (argc < 9) {
+        print_disk_search_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Parse arguments using getopt
+    int opt;
+    while ((opt = getopt(argc, argv, "d:q:g:m:L:k:W:H")) != -1) {
+        switch (opt) {
+        case 'd': // Disk index file
+            disk_file = optarg;
+            if (!std::ifstream(disk_file)) {
+                std::cerr << "Disk index file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            disk_file_flag = true;
+            break;
+        case 'q': // Query vectors file
+            query_file = optarg;
+            if (!std::ifstream(query_file)) {
+                std::cerr << "Query vectors file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            query_file_flag = true;
+            break;
+        case 'g': // Groundtruth vectors file
+            groundtruth_file = optarg;
+            if (!std::ifstream(groundtruth_file)) {
+                std::cerr << "Groundtruth file doesn't exist" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            groundtruth_file_flag = true;
+            break;
+        case 'm': // Number of query vectors
+            query_vectors_num = std::stoi(optarg);
+            if (query_vectors_num <= 0) {
+                std::cerr << "Query vectors number must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            query_vectors_num_flag = true;
+            break;
+        case 'L': // Swept search limits L
+            L_values = parse_list(optarg, "L");
+            break;
+        case 'k': // Swept numbers of nearest neighbors k
+            k_values = parse_list(optarg, "k");
+            for (int k : k_values) {
+                if (k > max_k) {
+                    std::cerr << "k cannot be larger than the groundtruth size (" << max_k << ")" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+            break;
+        case 'W': // Beam width
+            beam_width = std::stoi(optarg);
+            if (beam_width < 1) {
+                std::cerr << "Beam width must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'H': // Back the codes with huge pages
+            huge_pages_flag = true;
+            break;
+        default:
+            print_disk_search_usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Check for unexpected arguments
+    if (optind < argc) {
+        std::cerr << "Error: Unexpected argument \"" << argv[optind] << "\" provided." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Check if all mandatory flags are given
+    if (!disk_file_flag || !query_file_flag || !groundtruth_file_flag || !query_vectors_num_flag) {
+        print_disk_search_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Output parameters
+    std::cout << "-----Parameters-----" << std::endl;
+    std::cout << "Disk index file = " << disk_file << std::endl;
+    std::cout << "Query file = " << query_file << std::endl;
+    std::cout << "Groundtruth file = " << groundtruth_file << std::endl;
+    std::cout << "Query vectors number = " << query_vectors_num << std::endl;
+    std::cout << "L values = ";
+    print_list(L_values);
+    std::cout << "k values = ";
+    print_list(k_values);
+    std::cout << "Beam width = " << beam_width << std::endl;
+    if (huge_pages_flag) std::cout << "Using huge pages" << std::endl;
+    std::cout << std::endl;
+}
+
+// Print usage of the generator in cerr
+void print_generate_usage() {
+    std::cerr << "Usage: " << std::endl;
+    std::cerr << "---MANDATORY FLAGS---" << std::endl;
+    std::cerr << "-b <base file to write>" << std::endl;
+    std::cerr << "-q <query file to write>" << std::endl;
+    std::cerr << "-n <base vectors number>" << std::endl;
+    std::cerr << "-m <query vectors number>" << std::endl;
+
+    std::cerr << "---OPTIONAL FLAGS---" << std::endl;
+    std::cerr << "-d <dimension> (default: 100, the only dimension the executables read)" << std::endl;
+    std::cerr << "--labels <number of labels> (default: 100)" << std::endl;
+    std::cerr << "--zipf <exponent of the label frequencies, 0 for uniform labels> (default: 1)" << std::endl;
+    std::cerr << "--clusters <number of gaussian clusters of the points> (default: 100)" << std::endl;
+    std::cerr << "--spread <standard deviation of the points around their cluster center> (default: 0.5)" << std::endl;
+    std::cerr << "--query-mix <comma separated fractions of unfiltered, filtered, range and filtered range queries> (default: 0.5,0.5,0,0)" << std::endl;
+    std::cerr << "--seed <random seed> (default: 42)" << std::endl;
+}
+
+// Parse input arguments for the synthetic dataset generator
+void parse_generate(int argc, char *argv[], std::string &base_file, std::string &query_file, long &base_vectors_num, \
+                    int &query_vectors_num, int &dimension, int &labels, double &zipf, int &clusters, float &spread, \
+                    std::vector<double> &query_mix, unsigned long &seed) {
+    // Mandatory flags
+    bool base_file_flag = false, query_file_flag = false, base_vectors_num_flag = false, query_vectors_num_flag = false;
+
+    // For the generator, minimum arguements are 9
+    if (argc < 9) {
+        print_generate_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Define long options
+    struct option long_options[] = {
+        {"labels", required_argument, nullptr, 1},
+        {"zipf", required_argument, nullptr, 2},
+        {"clusters", required_argument, nullptr, 3},
+        {"spread", required_argument, nullptr, 4},
+        {"query-mix", required_argument, nullptr, 5},
+        {"seed", required_argument, nullptr, 6},
+        {nullptr, 0, nullptr, 0}    // Terminating null entry
+    };
+
+    // Parse arguments using getopt
+    int opt;
+    while ((opt = getopt_long(argc, argv, "b:q:n:m:d:", long_options, nullptr)) != -1) {
+        switch (opt) {
+        case 'b': // Base vectors file
+            base_file = optarg;
+            base_file_flag = true;
+            break;
+        case 'q': // Query vectors file
+            query_file = optarg;
+            query_file_flag = true;
+            break;
+        case 'n': // Number of base vectors
+            base_vectors_num = std::stol(optarg);
+            if (base_vectors_num <= 0 || base_vectors_num > std::numeric_limits<int>::max()) {
+                std::cerr << "Base vectors number must be positive and fit in an int" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            base_vectors_num_flag = true;
+            break;
+        case 'm': // Number of query vectors
+            query_vectors_num = std::stoi(optarg);
+            if (query_vectors_num <= 0) {
+                std::cerr << "Query vectors number must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            query_vectors_num_flag = true;
+            break;
+        case 'd': // Dimension of the vectors
+            dimension = std::stoi(optarg);
+            // The executables (and ./groundtruth) read vectors of a fixed dimension, so files of any other are unusable
+            if (dimension != 100) {
+                std::cerr << "Dimension must be 100, the dimension the executables read" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 1: // Number of labels
+            labels = std::stoi(optarg);
+            if (labels <= 0) {
+                std::cerr << "Number of labels must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 2: // Skew of the labels
+            zipf = std::stod(optarg);
+            if (zipf < 0) {
+                std::cerr << "Zipf exponent cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 3: // Number of clusters
+            clusters = std::stoi(optarg);
+            if (clusters <= 0) {
+                std::cerr << "Number of clusters must be positive" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 4: // Spread of the clusters
+            spread = std::stof(optarg);
+            if (spread < 0) {
+                std::cerr << "Spread cannot be negative" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 5: { // Fractions of the query types
+            query_mix.clear();
+            std::string list = optarg;
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t end = list.find(',', start);
+                if (end == std::string::npos) end = list.size();
+                query_mix.push_back(std::stod(list.substr(start, end - start)));
+                start = end + 1;
+            }
+            double sum = 0;
+            bool negative = false;
+            for (double fraction : query_mix) {
+                sum += fraction;
+                if (fraction < 0) negative = true;
+            }
+            if (query_mix.size() != 4 || negative || sum <= 0) {
+                std::cerr << "Query mix must be 4 non-negative fractions, not all 0" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            break;
+        }
+        case 6: // Random seed
+            seed = std::stoul(optarg);
+            break;
+        default:
+            print_generate_usage();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // Check for unexpected arguments
+    if (optind < argc) {
+        std::cerr << "Error: Unexpected argument \"" << argv[optind] << "\" provided." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Check if all mandatory flags are given
+    if (!base_file_flag || !query_file_flag || !base_vectors_num_flag || !query_vectors_num_flag) {
+        print_generate_usage();
+        exit(EXIT_FAILURE);
+    }
+
+    // Output parameters
+    std::cout << "-----Parameters-----" << std::endl;
+    std::cout << "Base file = " << base_file << std::endl;
+    std::cout << "Query file = " << query_file << std::endl;
+    std::cout << "Base vectors number = " << base_vectors_num << std::endl;
+    std::cout << "Query vectors number = " << query_vectors_num << std::endl;
+    std::cout << "Dimension = " << dimension << std::endl;
+    std::cout << "Labels = " << labels << " (zipf = " << zipf << ")" << std::endl;
+    std::cout << "Clusters = " << clusters << " (spread = " << spread << ")" << std::endl;
+    std::cout << "Query mix = " << query_mix[0] << "," << query_mix[1] << "," << query_mix[2] << "," << query_mix[3] << std::endl;
+    std::cout << "Seed = " << seed << std::endl;
+    std::cout << std::endl;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <limits>
+#include "compressed_graph.hpp"
+#include "filtered_greedy_search.hpp"
+#include "query_planner.hpp"
+
+// Returns the start nodes of the labels of a filtered query. Labels without points are ignored
+std::vector<int> filter_start_nodes(const LabelSet& filter, std::vector<int> *M) {
+    std::vector<int> starts;
+    for (Label f : filter.labels()) {
+        if (f < M->size() && (*M)[f] != -1) starts.push_back((*M)[f]);
+    }
+    return starts;
+}
+
+// Returns for every label of the filter (of all labels if it is empty) its start node candidate closest to the query
+std::vector<int> closest_start_nodes(const LabelSet& filter, const std::vector<std::vector<int>>& start_points, Vectors& vectors, int query) {
+    std::vector<Label> labels = filter.labels();
+    if (filter.empty()) {
+        for (Label f = 0; f < start_points.size(); f++) labels.push_back(f);
+    }
+
+    std::vector<int> starts;
+    for (Label f : labels) {
+        if (f >= start_points.size() || start_points[f].empty()) continue;
+
+        int closest = start_points[f][0];
+        float closest_distance = vectors.euclidean_distance(query, closest);
+        for (size_t i = 1; i < start_points[f].size(); i++) {
+            float distance = vectors.euclidean_distance(query, start_points[f][i]);
+            if (distance < closest_distance) {
+                closest = start_points[f][i];
+                closest_distance = distance;
+            }
+        }
+        starts.push_back(closest);
+    }
+    return starts;
+}
+
+// Returns the 'num_entry_points' entry points closest to 'query' (all of them if 0), nearest first
+std::vector<int> nearest_entry_points(const std::vector<int>& entry_points, int num_entry_points, Vectors& vectors, int query) {
+    std::vector<std::pair<float, int>> distances;
+    for (int start : entry_points) {
+        distances.push_back({vectors.euclidean_distance(query, start), start});
+    }
+    if (num_entry_points == 0 || num_entry_points > (int)distances.size()) num_entry_points = distances.size();
+    std::partial_sort(distances.begin(), distances.begin() + num_entry_points, distances.end());
+
+    std::vector<int> starts;
+    for (int i = 0; i < num_entry_points; i++) {
+        starts.push_back(distances[i].second);
+    }
+    return starts;
+}
+
+// Choose the plan of a filtered query from the number of points of its labels
+QueryPlan plan_filtered_query(const Vectors& vectors, int query, int brute_force_threshold, int large_L_threshold) {
+    // Points with several of the query's labels are counted more than once, which only overestimates the cost of the scan
+    size_t count = 0;
+    for (Label f : vectors.filters[query].labels()) {
+        if (f < vectors.postings.size()) count += vectors.postings[f].size();
+    }
+
+    if (count <= (size_t)brute_force_threshold) return PLAN_BRUTE_FORCE;
+    if (count <= (size_t)large_L_threshold) return PLAN_GRAPH_LARGE_L;
+    return PLAN_GRAPH;
+}
+
+// Exact k nearest neighbors of a filtered query, scanning the posting lists of its labels
+template <typename Graph>
+std::vector<int> FilteredBruteForce(Graph& graph, Vectors& vectors, int query, int k) {
+    std::vector<std::pair<float, int>> candidates;
+    std::vector<Label> labels = vectors.filters[query].labels();
+    for (size_t l = 0; l < labels.size(); l++) {
+        if (labels[l] >= vectors.postings.size()) continue;
+
+        for (int i : vectors.postings[labels[l]]) {
+            if (graph.is_deleted(i)) continue;
+
+            // A point with several of the query's labels is only considered for the first one of them
+            bool seen = false;
+            for (size_t m = 0; m < l && !seen; m++) seen = vectors.filters[i].contains(labels[m]);
+            if (seen) continue;
+
+            candidates.push_back({vectors.euclidean_distance(query, i), i});
+        }
+    }
+
+    int count = std::min(k, (int)candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+    std::vector<int> result;
+    for (int i = 0; i < count; i++) {
+        result.push_back(candidates[i].second);
+    }
+    return result;
+}
+
+// Answer a filtered query with the given plan
+template <typename Graph>
+std::vector<int> FilteredSearch(Graph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, \
+                                QueryPlan plan, int L_factor, const SearchTermination& termination, VisitedSet *visited) {
+    switch (plan) {
+    case PLAN_BRUTE_FORCE:
+        return FilteredBruteForce(graph, vectors, query, k);
+    case PLAN_GRAPH_LARGE_L:
+        return FilteredGreedySearch(graph, vectors, starts, query, k, L * L_factor, std::numeric_limits<int>::max(), termination, visited, false).first;
+    default:
+        return FilteredGreedySearch(graph, vectors, starts, query, k, L, std::numeric_limits<int>::max(), termination, visited, false).first;
+    }
+}
+
+template std::vector<int> FilteredBruteForce(DirectedGraph&, Vectors&, int, int);
+template std::vector<int> FilteredBruteForce(CompressedGraph&, Vectors&, int, int);
+template std::vector<int> FilteredSearch(DirectedGraph&, Vectors&, const std::vector<int>&, int, int, int, QueryPlan, int, const SearchTermination&, VisitedSet*);
+template std::vector<int> FilteredSearch(CompressedGraph&, Vectors&, const std::vector<int>&, int, int, int, QueryPlan, int, const SearchTermination&, VisitedSet*);
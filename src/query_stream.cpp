@@ -0,0 +1,63 @@
+#include <algorithm>    // std::min()
+#include <utility>      // std::swap()
+
+#include "query_stream.hpp"
+
+QueryStream::QueryStream(const std::string& file_name, int dimension, int read_num, int chunk_size, bool range_queries)
+    : file(file_name, std::ios::binary), record_size(QUERY_HEADER + dimension), chunk_size(chunk_size),
+      range_queries(range_queries), unread(0), remaining(0) {
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    // Read the number of queries
+    u_int32_t u_queries_num;
+    if (!file.read(reinterpret_cast<char*>(&u_queries_num), sizeof(u_queries_num))) return;
+    unread = u_queries_num;
+    remaining = std::min(static_cast<long>(u_queries_num), static_cast<long>(read_num));
+
+    spare.resize((size_t)chunk_size * record_size);
+    buffer.resize((size_t)chunk_size * record_size);
+    prefetch();
+}
+
+QueryStream::~QueryStream() {
+    if (pending.valid()) pending.wait();
+}
+
+// Start reading the next chunk into 'buffer'. Only the background read touches 'file' and 'buffer' until it is waited
+void QueryStream::prefetch() {
+    int count = std::min(unread, static_cast<long>(chunk_size));
+    if (count == 0) return;
+    unread -= count;
+    requested = count;
+
+    pending = std::async(std::launch::async, [this, count] {
+        size_t bytes = (size_t)count * record_size * sizeof(float);
+        file.read(reinterpret_cast<char*>(buffer.data()), bytes);
+        return static_cast<int>(file.gcount() / (record_size * sizeof(float)));
+    });
+}
+
+int QueryStream::next(Vectors& vectors) {
+    if (vectors.num_queries() < chunk_size) throw std::runtime_error("Not enough query slots for a chunk of queries");
+
+    first_query += loaded;
+    loaded = 0;
+    // A chunk may hold only skipped timestamp queries, so keep reading until a query is loaded or the file ends
+    while (loaded == 0 && remaining > 0 && pending.valid()) {
+        int records = pending.get();
+        // A short read means the file ended early
+        if (records < requested) unread = 0;
+        std::swap(spare, buffer);
+
+        for (int i = 0; i < records && remaining > 0; i++) {
+            if (vectors.set_query(loaded, spare.data() + (size_t)i * record_size, range_queries)) {
+                loaded++;
+                remaining--;
+            }
+        }
+
+        // Read the next chunk while this one is searched
+        if (remaining > 0) prefetch();
+    }
+    return loaded;
+}
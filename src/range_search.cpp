@@ -0,0 +1,37 @@
+#include <algorithm>
+#include "filtered_greedy_search.hpp"
+#include "range_search.hpp"
+#include "utils.hpp"
+
+// Exact k nearest neighbors of a range query, scanning the points of its range in the timestamp index
+std::vector<int> RangeBruteForce(DirectedGraph& graph, Vectors& vectors, int query, int k) {
+    ERROR_EXIT((int)vectors.time_index.size() != vectors.size(), "Timestamp index is not built")
+    auto [first, last] = vectors.time_index_bounds(vectors.query_range(query));
+
+    std::vector<std::pair<float, int>> candidates;
+    for (int pos = first; pos < last; pos++) {
+        int i = vectors.time_index[pos];
+        if (graph.is_deleted(i) || !vectors.same_filter(query, i)) continue;
+        candidates.push_back({vectors.euclidean_distance(query, i), i});
+    }
+
+    int count = std::min(k, (int)candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+    std::vector<int> result;
+    for (int i = 0; i < count; i++) {
+        result.push_back(candidates[i].second);
+    }
+    return result;
+}
+
+// Search for the k nearest neighbors of a range query, choosing between a scan of its range and a graph search
+std::vector<int> RangeSearch(DirectedGraph& graph, Vectors& vectors, const std::vector<int>& starts, int query, int k, int L, int limit, int threshold) {
+    ERROR_EXIT((int)vectors.time_index.size() != vectors.size(), "Timestamp index is not built")
+    auto [first, last] = vectors.time_index_bounds(vectors.query_range(query));
+
+    // Few points in the range: the scan is exact and visits fewer points than the graph search would
+    if (last - first <= threshold) return RangeBruteForce(graph, vectors, query, k);
+
+    return RangeGreedySearch(graph, vectors, starts, query, k, L, limit).first;
+}
@@ -0,0 +1,105 @@
+#include <cmath>        // std::lround()
+#include <utility>      // std::move()
+
+#include "result_cache.hpp"
+
+ResultCache::ResultCache(size_t capacity, float step)
+    : shard_capacity((capacity + RESULT_CACHE_SHARDS - 1) / RESULT_CACHE_SHARDS), step(step), shards(RESULT_CACHE_SHARDS) {}
+
+ResultCache::Key ResultCache::make_key(const LabelSet& filter, const float *values, int dimension, int k, int L) const {
+    Key key{filter.labels(), std::vector<int32_t>(dimension), k, L};
+    for (int i = 0; i < dimension; i++) key.codes[i] = std::lround(values[i] / step);
+    return key;
+}
+
+// FNV-1a over the fields of the key
+uint64_t ResultCache::hash(const Key& key) {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](uint32_t value) {
+        h ^= value;
+        h *= 1099511628211ull;
+    };
+    mix(key.k);
+    mix(key.L);
+    for (auto label : key.labels) mix(label);
+    for (auto code : key.codes) mix(code);
+    return h;
+}
+
+int ResultCache::find(Shard& shard, const Key& key, uint64_t key_hash) {
+    auto range = shard.index.equal_range(key_hash);
+    for (auto it = range.first; it != range.second; it++) {
+        if (shard.entries[it->second].key == key) return it->second;
+    }
+    return -1;
+}
+
+bool ResultCache::lookup(const LabelSet& filter, const float *values, int dimension, int k, int L, std::vector<int>& result) {
+    Key key = make_key(filter, values, dimension, k, L);
+    uint64_t key_hash = hash(key);
+    Shard& shard = shards[key_hash % RESULT_CACHE_SHARDS];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    int position = find(shard, key, key_hash);
+    if (position == -1) {
+        miss_count++;
+        return false;
+    }
+
+    Entry& entry = shard.entries[position];
+    entry.referenced = true;
+    result = entry.result;
+    hit_count++;
+    return true;
+}
+
+void ResultCache::insert(const LabelSet& filter, const float *values, int dimension, int k, int L, const std::vector<int>& result) {
+    if (shard_capacity == 0) return;
+
+    Key key = make_key(filter, values, dimension, k, L);
+    uint64_t key_hash = hash(key);
+    Shard& shard = shards[key_hash % RESULT_CACHE_SHARDS];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    // Another thread may have cached the same query meanwhile
+    if (find(shard, key, key_hash) != -1) return;
+
+    int position;
+    if (shard.entries.size() < shard_capacity) {
+        position = shard.entries.size();
+        shard.entries.emplace_back();
+    } else {
+        // CLOCK: advance the hand, giving referenced entries a second chance, until an unreferenced one is found
+        while (shard.entries[shard.hand].referenced) {
+            shard.entries[shard.hand].referenced = false;
+            shard.hand = (shard.hand + 1) % shard.entries.size();
+        }
+        position = shard.hand;
+        shard.hand = (shard.hand + 1) % shard.entries.size();
+
+        // Remove the evicted entry from the index
+        auto range = shard.index.equal_range(hash(shard.entries[position].key));
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == position) {
+                shard.index.erase(it);
+                break;
+            }
+        }
+        eviction_count++;
+    }
+
+    Entry& entry = shard.entries[position];
+    entry.key = std::move(key);
+    entry.result = result;
+    entry.referenced = false;
+    shard.index.emplace(key_hash, position);
+}
+
+size_t ResultCache::size() {
+    size_t count = 0;
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries.size();
+    }
+    return count;
+}
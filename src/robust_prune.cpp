@@ -34,8 +34,10 @@ void robust_prune(DirectedGraph *G, Vectors& vectors, int *Pf, int p, std::set<s
         for (auto it = V.begin() ; it != V.end() ; ) {
             int p_prime = it->second;
 
-            // if a ⋅ d(p*, p') <= d(p, p') then remove p' from V
-            if (a * vectors.euclidean_distance(Pf[p_star], Pf[p_prime]) <= vectors.euclidean_distance(Pf[p], Pf[p_prime])) it = V.erase(it);
+            // if a ⋅ d(p*, p') <= d(p, p') then remove p' from V. d(p, p') is the distance stored in V, and d(p*, p') is
+            // abandoned once it exceeds d(p, p') / a, since p' is kept then
+            float bound = it->first / a;
+            if (a * vectors.euclidean_distance(Pf[p_star], Pf[p_prime], bound) <= it->first) it = V.erase(it);
             else it++;
         }
     }
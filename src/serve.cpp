@@ -0,0 +1,375 @@
+#define VEC_DIMENSION 100
+
+#include <algorithm>    // std::max()
+#include <chrono>       // For high-resolution clock
+#include <condition_variable>
+#include <csignal>      // signal()
+#include <cstdint>      // int32_t, uint32_t
+#include <cstring>      // std::memcpy()
+#include <ctime>        // time()
+#include <iostream>     // std::cerr
+#include <limits>
+#include <mutex>
+#include <string>       // std::string
+#include <sys/socket.h> // socket(), bind(), listen(), accept()
+#include <sys/un.h>     // sockaddr_un
+#include <thread>
+#include <unistd.h>     // read(), write(), close(), unlink()
+
+#include "directed_graph.hpp"
+#include "filtered_greedy_search.hpp"
+#include "findmedoid.hpp"
+#include "huge_pages.hpp"
+#include "numa_placement.hpp"
+#include "parameter_parser.hpp"
+#include "query_planner.hpp"
+#include "result_cache.hpp"
+#include "utils.hpp"
+#include "vamana.hpp"
+#include "vectors.hpp"
+
+// Query server of a saved graph. The graph is loaded once and batches of requests are answered until the client
+// closes the connection (or standard input ends). Up to --max-connections connections of a unix domain socket are
+// served at once, each by a thread of its own that reads its batches and writes their responses. The main thread
+// answers the batches of all connections that are waiting together, searching their requests in parallel with the
+// OpenMP threads
+// Log messages go to cerr, since cout carries the responses when serving standard input
+
+// Protocol (native byte order, 4 byte fields):
+// Batch:    number of requests n (0 closes the connection), followed by n requests
+// Request:  k (int), L (int), filter (float, -1 for unfiltered queries) and the vector values (floats)
+// Response: for every request in order, the number of results r (int), followed by r indexes of base vectors, nearest
+//           first. Invalid requests (k < 1, L < k) and filters that no base vector has get 0 results
+
+// ./serve -b dummy/dummy-data.bin -v vamana.bin -n 10000 -t 50 < requests.bin > responses.bin
+// ./serve -b dummy/dummy-data.bin -v vamana.bin -n 10000 -t 50 -u /tmp/vamana.sock --max-batch 256
+// ./serve -b dummy/dummy-data.bin -v vamana.bin -n 10000 -t 50 -u /tmp/vamana.sock --cache 100000
+// ./serve -b dummy/dummy-data.bin -v vamana.bin -n 10000 -t 50 -u /tmp/vamana.sock --max-connections 64
+
+// The loaded index and the search options that every request is answered with
+struct Index {
+    DirectedGraph *g;
+    Vectors *vectors;
+    std::vector<int> *M;
+    std::vector<int> unfiltered_entry_points;
+    int entry_points, limit, brute_force_threshold, large_L_threshold, L_factor;
+    ResultCache *cache;         // Results of repeated requests, nullptr if they are not cached
+    // Start node candidates of every label, of which the closest to the request is used. nullptr if the medoids are used
+    std::vector<std::vector<int>> *start_points = nullptr;
+    int global_medoid = -1;
+    SearchTermination termination = {};  // Early termination of the searches
+};
+
+// Helper function to read exactly 'bytes' bytes from 'fd'. Returns false if the input ends first
+static bool read_all(int fd, void *data, size_t bytes) {
+    char *position = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t count = read(fd, position, bytes);
+        if (count <= 0) return false;
+        position += count;
+        bytes -= count;
+    }
+    return true;
+}
+
+// Helper function to write all 'bytes' bytes to 'fd'. Returns false if the other end is closed
+static bool write_all(int fd, const void *data, size_t bytes) {
+    const char *position = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t count = write(fd, position, bytes);
+        if (count <= 0) return false;
+        position += count;
+        bytes -= count;
+    }
+    return true;
+}
+
+// Answer the request at 'request', storing its vector in query slot 'slot'
+static std::vector<int> answer(Index& index, int slot, const float *request) {
+    int32_t k, L;
+    std::memcpy(&k, &request[0], sizeof(k));
+    std::memcpy(&L, &request[1], sizeof(L));
+    if (k < 1 || L < k) return {};
+
+    // Requests are stored as query records of type 0 (unfiltered) or 1 (filtered)
+    std::vector<float> record(QUERY_HEADER + VEC_DIMENSION);
+    record[0] = request[2] == -1 ? 0 : 1;
+    record[1] = request[2];
+    record[2] = record[3] = -1;
+    std::memcpy(&record[QUERY_HEADER], &request[3], VEC_DIMENSION * sizeof(float));
+    index.vectors->set_query(slot, record.data());
+
+    Vectors& vectors = *index.vectors;
+    int query = vectors.size() + slot;
+    const LabelSet& filter = vectors.filters[query];
+    std::vector<int> result;
+    // Repeated requests skip the search
+    if (index.cache && index.cache->lookup(filter, vectors[query], VEC_DIMENSION, k, L, result)) return result;
+
+    // Every thread reuses its visited markers for all of its requests, instead of allocating them per search
+    thread_local VisitedSet visited;
+
+    if (filter.empty()) {
+        std::vector<int> candidates;
+        if (index.start_points) {
+            candidates = closest_start_nodes(filter, *index.start_points, vectors, query);
+            if (index.global_medoid != -1) candidates.push_back(index.global_medoid);
+        }
+        const std::vector<int>& entry_points = index.start_points ? candidates : index.unfiltered_entry_points;
+        std::vector<int> starts = nearest_entry_points(entry_points, index.entry_points, vectors, query);
+        result = UnfilteredGreedySearch(*index.g, vectors, starts, query, k, L, index.limit, index.termination, &visited).first;
+    } else {
+        std::vector<int> starts = index.start_points ? closest_start_nodes(filter, *index.start_points, vectors, query) \
+                                                     : filter_start_nodes(filter, index.M);
+        if (starts.empty()) return {};
+        QueryPlan plan = plan_filtered_query(vectors, query, index.brute_force_threshold, index.large_L_threshold);
+        result = FilteredSearch(*index.g, vectors, starts, query, k, L, plan, index.L_factor, index.termination, &visited);
+    }
+
+    if (index.cache) index.cache->insert(filter, vectors[query], VEC_DIMENSION, k, L, result);
+    return result;
+}
+
+// A batch of requests of a connection and the results of its requests
+struct Batch {
+    int first_slot;             // Query slot of the first request, the next ones use the slots after it
+    int size;
+    const float *requests;
+    std::vector<std::vector<int>> *results;
+    bool answered = false;
+};
+
+// Batches waiting to be answered, read by the threads of the open connections. Every connection has its own 'max_batch'
+// query slots, so the batches of different connections can be answered together
+class BatchQueue {
+public:
+    BatchQueue(int connections, int max_batch) {
+        for (int c = connections - 1; c >= 0; c--) free_slots.push_back(c * max_batch);
+    }
+
+    // Wait until fewer than the maximum connections are open and return the first query slot of a new one
+    int open() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !free_slots.empty(); });
+        int first_slot = free_slots.back();
+        free_slots.pop_back();
+        return first_slot;
+    }
+
+    // Free the query slots of a closed connection
+    void close(int first_slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_slots.push_back(first_slot);
+        changed.notify_all();
+    }
+
+    // Add 'batch' to the queue and wait until it is answered
+    void answer(Batch& batch) {
+        std::unique_lock<std::mutex> lock(mutex);
+        waiting.push_back(&batch);
+        changed.notify_all();
+        changed.wait(lock, [&batch] { return batch.answered; });
+    }
+
+    // Wait until batches are added and remove all of them from the queue
+    std::vector<Batch*> take() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !waiting.empty(); });
+        std::vector<Batch*> batches;
+        batches.swap(waiting);
+        return batches;
+    }
+
+    // Wake the connections of the answered 'batches'
+    void finish(const std::vector<Batch*>& batches) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Batch *batch : batches) batch->answered = true;
+        changed.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<Batch*> waiting;
+    std::vector<int> free_slots;
+};
+
+// Answer the requests of all 'batches' in parallel
+static void answer_batches(Index& index, const std::vector<Batch*>& batches) {
+    const int request_size = 3 + VEC_DIMENSION;
+    std::vector<std::pair<Batch*, int>> requests;
+    for (Batch *batch : batches) {
+        batch->results->resize(batch->size);
+        for (int i = 0; i < batch->size; i++) requests.push_back({batch, i});
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t r = 0; r < requests.size(); r++) {
+        Batch& batch = *requests[r].first;
+        int i = requests[r].second;
+        (*batch.results)[i] = answer(index, batch.first_slot + i, &batch.requests[(size_t)i * request_size]);
+    }
+}
+
+// Connections log from their own threads, so that their lines are not mixed
+static std::mutex log_mutex;
+
+// Print the statistics of the result cache (if there is one) in cerr
+static void print_cache_stats(Index& index) {
+    if (!index.cache) return;
+    std::cerr << "Result cache: " << index.cache->hits() << " hits, " << index.cache->misses() << " misses (" \
+              << 100 * index.cache->hit_rate() << "% hit rate), " << index.cache->size() << " results, " \
+              << index.cache->evictions() << " evictions" << std::endl;
+}
+
+// Answer batches read from 'in' and write their responses to 'out', until the input ends or a batch of 0 requests
+// Requests use the query slots from 'first_slot' on. Batches are answered by the main thread through 'queue', or by
+// the calling thread if it is nullptr. Returns the number of answered requests
+static long serve(Index& index, int in, int out, int max_batch, int first_slot = 0, BatchQueue *queue = nullptr) {
+    const int request_size = 3 + VEC_DIMENSION;
+    std::vector<float> requests;
+    std::vector<std::vector<int>> results;
+    std::vector<int32_t> response;
+    long served = 0;
+
+    uint32_t n;
+    while (read_all(in, &n, sizeof(n)) && n > 0) {
+        if ((int)n > max_batch) {
+            std::cerr << "Batch of " << n << " requests is larger than the max batch (" << max_batch << ")" << std::endl;
+            break;
+        }
+        requests.resize((size_t)n * request_size);
+        if (!read_all(in, requests.data(), requests.size() * sizeof(float))) break;
+
+        // Every request of the batch has its own query slot, so they are searched in parallel
+        Batch batch{first_slot, (int)n, requests.data(), &results};
+        if (queue) queue->answer(batch);
+        else answer_batches(index, {&batch});
+
+        response.clear();
+        for (const auto& result : results) {
+            response.push_back(result.size());
+            response.insert(response.end(), result.begin(), result.end());
+        }
+        if (!write_all(out, response.data(), response.size() * sizeof(int32_t))) break;
+        served += n;
+    }
+    return served;
+}
+
+// Helper function to return elapsed time in seconds
+static float elapsed_time(std::chrono::time_point<std::chrono::steady_clock> start) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+int main(int argc, char *argv[]) {
+    srand(time(NULL));  // Seed for randomization
+
+    std::string base_file, vamana_file, socket_file = "", labels_file = "";
+    int base_vectors_num, t, max_batch = SERVE_MAX_BATCH, max_connections = SERVE_MAX_CONNECTIONS, cache_size = 0, limit = std::numeric_limits<int>::max(), entry_points = 0, \
+        entry_candidates = 1;
+    bool global_medoid_flag = false, pin_threads_flag = false, interleave_flag = false, huge_pages_flag = false;
+    int brute_force_threshold = PLANNER_BRUTE_FORCE_THRESHOLD, large_L_threshold = PLANNER_LARGE_L_THRESHOLD, \
+        L_factor = PLANNER_L_FACTOR;
+    SearchTermination termination;
+
+    parse_serve(VEC_DIMENSION, argc, argv, base_file, vamana_file, socket_file, base_vectors_num, t, max_batch, max_connections, cache_size, \
+                labels_file, limit, entry_points, global_medoid_flag, brute_force_threshold, large_L_threshold, L_factor, \
+                entry_candidates, termination, pin_threads_flag, interleave_flag, huge_pages_flag);
+
+    // Threads are pinned before the pool is used, and the loaded index is interleaved across the NUMA nodes
+    if (pin_threads_flag) std::cerr << "Pinned " << pin_threads() << " threads" << std::endl;
+    if (interleave_flag && !interleave_memory(true)) std::cerr << "Memory interleaving is not available (single NUMA node)" << std::endl;
+    // The base vectors are allocated on huge pages, if they are available, from now on
+    set_huge_pages(huge_pages_flag);
+
+    // Load the base vectors and the graph once, with a query slot for every request of a batch of every connection
+    std::cerr << "Loading..." << std::endl;
+    auto load_start = std::chrono::steady_clock::now();
+    Vectors vectors(base_file, VEC_DIMENSION, base_vectors_num, max_batch * (socket_file.empty() ? 1 : max_connections));
+    if (!labels_file.empty()) vectors.read_labels(labels_file);
+
+    DirectedGraph *g = read_vamana_from_file(vamana_file);
+    ERROR_EXIT(g->get_size() != vectors.size(), "Vamana file does not match the number of base vectors")
+    // Freed vertices of a loaded graph hold no point, so they must not be chosen as start nodes
+    for (auto v : g->get_free_vertices()) vectors.remove_posting(v);
+
+    Index index{g, &vectors, find_medoid(vectors, t), {}, entry_points, limit, brute_force_threshold, large_L_threshold, L_factor, \
+                cache_size > 0 ? new ResultCache(cache_size) : nullptr};
+    for (int start : *index.M) {
+        if (start != -1) index.unfiltered_entry_points.push_back(start);
+    }
+    if (global_medoid_flag) {
+        index.global_medoid = find_global_medoid(vectors, t);
+        index.unfiltered_entry_points.push_back(index.global_medoid);
+    }
+    if (entry_candidates > 1) {
+        index.start_points = find_start_points(vectors, std::max(t, PLANNER_ENTRY_SAMPLE * entry_candidates), entry_candidates, \
+                                                index.M);
+    }
+    index.termination = termination;
+    // Memory of the requests is allocated on the node of the thread that answers them
+    if (interleave_flag) interleave_memory(false);
+    if (huge_pages_flag) std::cerr << huge_page_bytes() / double(1 << 20) << " MB backed by huge pages" << std::endl;
+    std::cerr << "Load time: " << elapsed_time(load_start) << " seconds" << std::endl;
+
+    // A client that disconnects before reading its responses must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    if (socket_file.empty()) {
+        auto serve_start = std::chrono::steady_clock::now();
+        long served = serve(index, STDIN_FILENO, STDOUT_FILENO, max_batch);
+        std::cerr << "Served " << served << " requests in " << elapsed_time(serve_start) << " seconds" << std::endl;
+        print_cache_stats(index);
+    } else {
+        int server = socket(AF_UNIX, SOCK_STREAM, 0);
+        ERROR_EXIT(server == -1, "Cannot create socket")
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        ERROR_EXIT(socket_file.size() >= sizeof(address.sun_path), "Socket file path is too long")
+        std::strcpy(address.sun_path, socket_file.c_str());
+        unlink(socket_file.c_str());    // Remove the socket of a previous run
+        ERROR_EXIT(bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1, "Cannot bind socket " << socket_file)
+        ERROR_EXIT(listen(server, SOMAXCONN) == -1, "Cannot listen on socket " << socket_file)
+        std::cerr << "Listening on " << socket_file << std::endl;
+
+        // Every accepted connection is served by a thread of its own, once another one closes if the maximum are open
+        BatchQueue queue(max_connections, max_batch);
+        std::thread acceptor([&]() {
+            while (true) {
+                int first_slot = queue.open();
+                int client = accept(server, nullptr, nullptr);
+                if (client == -1) {
+                    queue.close(first_slot);
+                    continue;
+                }
+
+                std::thread([&index, &queue, client, first_slot, max_batch]() {
+                    auto serve_start = std::chrono::steady_clock::now();
+                    long served = serve(index, client, client, max_batch, first_slot, &queue);
+                    close(client);
+                    queue.close(first_slot);
+
+                    std::lock_guard<std::mutex> lock(log_mutex);
+                    std::cerr << "Served " << served << " requests in " << elapsed_time(serve_start) << " seconds" << std::endl;
+                    print_cache_stats(index);
+                }).detach();
+            }
+        });
+
+        // The batches that arrive while others are answered are answered together with the OpenMP threads
+        while (true) {
+            std::vector<Batch*> batches = queue.take();
+            answer_batches(index, batches);
+            queue.finish(batches);
+        }
+    }
+
+    delete index.cache;
+    delete index.M;
+    delete index.start_points;
+    delete g;
+    return 0;
+}
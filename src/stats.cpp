@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <iostream>
+#include <omp.h>
+
+#include "stats.hpp"
+
+thread_local SearchStats thread_stats;
+StatsCollector build_stats;
+
+StatsCollector::StatsCollector() : samples(omp_get_max_threads()) {}
+
+// Store the counters of the current thread. Every thread only appends to its own list, so no locking is needed
+void StatsCollector::end() {
+    size_t thread = omp_get_thread_num();
+    if (thread < samples.size()) samples[thread].push_back(thread_stats);
+}
+
+// Number of stored queries
+size_t StatsCollector::size() const {
+    size_t count = 0;
+    for (const auto& thread_samples : samples) count += thread_samples.size();
+    return count;
+}
+
+// Returns the p-th percentile of the values of a counter
+static long percentile_of(std::vector<long>& values, double p) {
+    if (values.empty()) return 0;
+    size_t rank = std::min(values.size() - 1, (size_t)(p / 100 * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+// Returns the p-th percentile of every counter over all stored queries
+SearchStats StatsCollector::percentile(double p) const {
+    std::vector<long> distances, abandoned, expansions, insertions, evictions, visited;
+    for (const auto& thread_samples : samples) {
+        for (const auto& stats : thread_samples) {
+            distances.push_back(stats.distances);
+            abandoned.push_back(stats.abandoned);
+            expansions.push_back(stats.expansions);
+            insertions.push_back(stats.insertions);
+            evictions.push_back(stats.evictions);
+            visited.push_back(stats.visited);
+        }
+    }
+
+    SearchStats result;
+    result.distances = percentile_of(distances, p);
+    result.abandoned = percentile_of(abandoned, p);
+    result.expansions = percentile_of(expansions, p);
+    result.insertions = percentile_of(insertions, p);
+    result.evictions = percentile_of(evictions, p);
+    result.visited = percentile_of(visited, p);
+    return result;
+}
+
+// Returns the average of every counter over all stored queries
+SearchStats StatsCollector::mean() const {
+    SearchStats result;
+    long count = size();
+    if (count == 0) return result;
+
+    for (const auto& thread_samples : samples) {
+        for (const auto& stats : thread_samples) {
+            result.distances += stats.distances;
+            result.abandoned += stats.abandoned;
+            result.expansions += stats.expansions;
+            result.insertions += stats.insertions;
+            result.evictions += stats.evictions;
+            result.visited += stats.visited;
+        }
+    }
+    result.distances /= count;
+    result.abandoned /= count;
+    result.expansions /= count;
+    result.insertions /= count;
+    result.evictions /= count;
+    result.visited /= count;
+    return result;
+}
+
+// Print the p50, p90, p99 and max of every counter
+void StatsCollector::print(const std::string& title) const {
+    SearchStats p50 = percentile(50), p90 = percentile(90), p99 = percentile(99), max = percentile(100);
+
+    std::cout << title << " counters over " << size() << " samples (p50 / p90 / p99 / max):" << std::endl;
+    std::cout << "  distances:  " << p50.distances << " / " << p90.distances << " / " << p99.distances << " / " << max.distances << std::endl;
+    std::cout << "  abandoned:  " << p50.abandoned << " / " << p90.abandoned << " / " << p99.abandoned << " / " << max.abandoned << std::endl;
+    std::cout << "  expansions: " << p50.expansions << " / " << p90.expansions << " / " << p99.expansions << " / " << max.expansions << std::endl;
+    std::cout << "  insertions: " << p50.insertions << " / " << p90.insertions << " / " << p99.insertions << " / " << max.insertions << std::endl;
+    std::cout << "  evictions:  " << p50.evictions << " / " << p90.evictions << " / " << p99.evictions << " / " << max.evictions << std::endl;
+    std::cout << "  visited:    " << p50.visited << " / " << p90.visited << " / " << p99.visited << " / " << max.visited << std::endl;
+}
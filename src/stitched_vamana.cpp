@@ -1,3 +1,4 @@
+#include "build_profile.hpp"
 #include "stitched_vamana.hpp"
 #include "filtered_robust_prune.hpp"
 #include "vamana.hpp"
@@ -10,38 +11,34 @@ DirectedGraph *stitched_vamana(Vectors& P, float a, int L_small, int R_small, in
     else G = new DirectedGraph(n);
 
     // For each filter find the corresponding graph and stitch them together
-    int filters_size = P.filters_map.size();
-    float* filters = new float[filters_size];
-    int i = 0;
-    for (const auto& pair : P.filters_map) {
-        filters[i++] = pair.first;
+    // Posting lists are contiguous arrays, so they are used as Pf directly
+    int filters_size = P.num_labels();
+    long total = 0;
+    for (int f = 0 ; f < filters_size ; f++) {
+        if (P.postings[f].size() > 1) total += P.postings[f].size();
     }
+    build_profile.begin(total);
 
     #pragma omp parallel for
-    for (int i = 0 ; i < filters_size ; i++) {
-        std::unordered_set<int> list = P.filters_map[filters[i]];
-        int size = list.size();
-        if (size == 1) {
+    for (int f = 0 ; f < filters_size ; f++) {
+        int size = P.postings[f].size();
+        if (size <= 1) {
             continue;
         }
-        int *P_f = new int[size];
+        int *P_f = P.postings[f].data();
 
-        size_t index = 0;
-        for (int value : list) {
-            P_f[index++] = value;
-        }
-
-        DirectedGraph *G_f = vamana(P, P_f, index, a, L_small, R_small, random_medoid_flag, random_subset_medoid_flag, limit);
+        DirectedGraph *G_f = vamana(P, P_f, size, a, L_small, R_small, random_medoid_flag, random_subset_medoid_flag, limit);
         #pragma omp critical
         {
+            PhaseTimer timer(PHASE_STITCHING);
             G->stitch(G_f, P_f);
         }
 
-        delete[] P_f;
         delete G_f;
     }
 
     // For each vertex call the filtered robust prune
+    PhaseTimer timer(PHASE_FINAL_PRUNE);
     int size = P.size();
     for (int i = 0 ; i < size ; i++) {
         std::unordered_set<int> neighbors_i = G->get_neighbors(i);
@@ -54,6 +51,5 @@ DirectedGraph *stitched_vamana(Vectors& P, float a, int L_small, int R_small, in
         filtered_robust_prune(G, P, i, ordered_neighbors_i, a, R_stitched);
     }
 
-    delete[] filters;
     return G;
 }
\ No newline at end of file
@@ -5,8 +5,11 @@
 #include <random>
 #include <string>
 
+#include "build_profile.hpp"
+#include "chunked_reader.hpp"
 #include "greedy_search.hpp"
 #include "robust_prune.hpp"
+#include "stats.hpp"
 #include "utils.hpp"
 #include "vamana.hpp"
 
@@ -96,9 +99,12 @@ DirectedGraph *vamana(Vectors& P, int *Pf, int n, float a, int L, int R, bool ra
     
     // Init medoid
     int s;
-    if (!random_medoid_flag && !random_subset_medoid_flag) s = medoid(P, Pf, n);
-    else if (random_medoid_flag) s = random_medoid(n);
-    else s = random_subset_medoid(P, Pf, n);
+    {
+        PhaseTimer timer(PHASE_MEDOID);
+        if (!random_medoid_flag && !random_subset_medoid_flag) s = medoid(P, Pf, n);
+        else if (random_medoid_flag) s = random_medoid(n);
+        else s = random_subset_medoid(P, Pf, n);
+    }
 
     // Create the random permutation sigma (σ)
     int *sigma = new int[n];
@@ -112,23 +118,36 @@ DirectedGraph *vamana(Vectors& P, int *Pf, int n, float a, int L, int R, bool ra
     std::shuffle(sigma, sigma + n, rng);
     
     for (int i = 0; i < n; i++) {
-        auto [Lset, V] = GreedySearch(*G, P, Pf, n, s, sigma[i], 1, L, limit);
-        robust_prune(G, P, Pf, sigma[i], V, a, R);
-
-        const auto& N_out_sigma_i = G->get_neighbors(sigma[i]);
-        for (auto j : N_out_sigma_i) {
-            const auto& N_out_j = G->get_neighbors(j);
-            if ((int)N_out_j.size() + 1 > R) {
-                std::set<std::pair<float, int>> new_N_out_j;
-                for (auto v : N_out_j) {
-                    new_N_out_j.insert({P.euclidean_distance(Pf[j], Pf[v]), v});
+        STATS_BEGIN(build_stats);
+        std::set<std::pair<float, int>> V;
+        {
+            PhaseTimer timer(PHASE_GREEDY_SEARCH);
+            V = GreedySearch(*G, P, Pf, n, s, sigma[i], 1, L, limit).second;
+        }
+        {
+            PhaseTimer timer(PHASE_ROBUST_PRUNE);
+            robust_prune(G, P, Pf, sigma[i], V, a, R);
+        }
+
+        {
+            PhaseTimer timer(PHASE_BACK_EDGES);
+            const auto& N_out_sigma_i = G->get_neighbors(sigma[i]);
+            for (auto j : N_out_sigma_i) {
+                const auto& N_out_j = G->get_neighbors(j);
+                if ((int)N_out_j.size() + 1 > R) {
+                    std::set<std::pair<float, int>> new_N_out_j;
+                    for (auto v : N_out_j) {
+                        new_N_out_j.insert({P.euclidean_distance(Pf[j], Pf[v]), v});
+                    }
+                    new_N_out_j.insert({P.euclidean_distance(Pf[j], Pf[sigma[i]]), sigma[i]});
+                    robust_prune(G, P, Pf, j, new_N_out_j, a, R);
+                } else {
+                    G->insert(j, sigma[i]);
                 }
-                new_N_out_j.insert({P.euclidean_distance(Pf[j], Pf[sigma[i]]), sigma[i]});
-                robust_prune(G, P, Pf, j, new_N_out_j, a, R);
-            } else {
-                G->insert(j, sigma[i]);
             }
         }
+        STATS_END(build_stats);
+        build_profile.point_done();
     }
 
     delete[] sigma;
@@ -155,32 +174,55 @@ void write_vamana_to_file(DirectedGraph& g, const std::string& file_name) {
         }
     }
 
+    // Deleted vertices are optionally written at the end of the file, so files without deletions are unchanged
+    const auto& tombstones = g.get_tombstones();
+    const auto& free_vertices = g.get_free_vertices();
+    if (!tombstones.empty() || !free_vertices.empty()) {
+        for (const auto *list : {&free_vertices, &tombstones}) {
+            int list_size = list->size();
+            file.write(reinterpret_cast<char *>(&list_size), sizeof(list_size));
+            file.write(reinterpret_cast<const char *>(list->data()), list_size * sizeof(Vertex));
+        }
+    }
+
     file.close();
 }
 
 // Reads (loads) a vamana graph from a (binary) file
 // The function acts as a constructor for a vamana graph, returning a pointer to the allocated memory
 DirectedGraph *read_vamana_from_file(const std::string& file_name) {
-    std::ifstream file(file_name, std::ios::binary);
-    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+    // The file is read in large chunks, the next one in flight while a chunk is decoded
+    ChunkedReader file(file_name);
 
     // Firstly, read the number of sets (vertices) the graph has
     int num_of_sets;
-    file.read(reinterpret_cast<char *>(&num_of_sets), sizeof(num_of_sets));
+    if (!file.read(&num_of_sets, sizeof(num_of_sets))) throw std::runtime_error("Error reading file: " + file_name);
 
     // Init a graph object and start constructing it based on file's data
     DirectedGraph *g = new DirectedGraph(num_of_sets);
+    std::vector<int> neighbors;
     // For every vertex
     for (int i = 0, set_size; i < num_of_sets; i++) {
-        file.read(reinterpret_cast<char *>(&set_size), sizeof(set_size));
         // Load and then store the neighbors (indexes) of each vertex
-        for (int j = 0, neighbor_index; j < set_size; j++) {
-            file.read(reinterpret_cast<char *>(&neighbor_index), sizeof(neighbor_index));
-            g->insert(i, neighbor_index);
-        }
+        if (!file.read(&set_size, sizeof(set_size))) throw std::runtime_error("Error reading file: " + file_name);
+        neighbors.resize(set_size);
+        if (!file.read(neighbors.data(), set_size * sizeof(int))) throw std::runtime_error("Error reading file: " + file_name);
+        for (int neighbor_index : neighbors) g->insert(i, neighbor_index);
     }
 
-    file.close();
+    // Read the (optional) free and tombstoned vertices. Free vertices have no edges, so they are freed right away
+    int list_size;
+    if (file.read(&list_size, sizeof(list_size))) {
+        std::vector<int> list(list_size);
+        if (!file.read(list.data(), list_size * sizeof(int))) throw std::runtime_error("Error reading file: " + file_name);
+        for (int v : list) g->mark_deleted(v);
+        g->free_tombstones();
+
+        if (!file.read(&list_size, sizeof(list_size))) throw std::runtime_error("Error reading file: " + file_name);
+        list.resize(list_size);
+        if (!file.read(list.data(), list_size * sizeof(int))) throw std::runtime_error("Error reading file: " + file_name);
+        for (int v : list) g->mark_deleted(v);
+    }
 
     return g;
 }
\ No newline at end of file
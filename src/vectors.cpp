@@ -2,6 +2,9 @@
 #include <algorithm>
 #include <immintrin.h>
 
+#include "chunked_reader.hpp"
+#include "huge_pages.hpp"
+#include "stats.hpp"
 #include "vectors.hpp"
 #include "utils.hpp"
 
@@ -9,48 +12,56 @@
 Vectors::Vectors(const std::string& file_name, int vectors_dimention, int num_read_vectors, int queries_num) 
     : base_size(0), dimention(vectors_dimention), queries(queries_num) {
     
-    std::ifstream file(file_name, std::ios::binary);
-    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+    // The file is read in large chunks, the next one in flight while a chunk is decoded
+    ChunkedReader file(file_name);
 
     // Read the number of vectors
     u_int32_t u_max_vectors;
-    if (!file.read(reinterpret_cast<char*>(&u_max_vectors), sizeof(u_max_vectors))) return;
+    if (!file.read(&u_max_vectors, sizeof(u_max_vectors))) return;
     // Keep the smaller number so it is controllable the number of vectors that  will be read
     int max_vectors = std::min(static_cast<int>(u_max_vectors), num_read_vectors);
     
-    vectors = new float*[max_vectors + queries];
-    filters = new float[max_vectors + queries];
+    vectors = new float*[max_vectors + queries]();
+    filters = new LabelSet[max_vectors + queries];
+    timestamps = new float[max_vectors + queries]();
+    ranges.resize(queries);
+    // Base vectors are stored back to back, so that searches touch fewer pages
+    float *block = allocate_block(max_vectors);
 
-    while (base_size < max_vectors && file) {
-        if (!file.read(reinterpret_cast<char*>(&filters[base_size]), sizeof(float))) break;
-        filters_map[filters[base_size]].insert(base_size);
+    while (base_size < max_vectors) {
+        float filter;
+        if (!file.read(&filter, sizeof(float))) break;
+        Label label = add_label(filter);
+        filters[base_size] = LabelSet(label);
+        postings[label].push_back(base_size);
 
-        // Ignore the timestamp value
-        file.seekg(sizeof(float), std::ios::cur);
+        if (!file.read(&timestamps[base_size], sizeof(float))) break;
 
         // Read the vectors values
-        vectors[base_size] = new float[dimention];
-        if (!file.read(reinterpret_cast<char*>(vectors[base_size]), dimention * sizeof(float))) {
+        vectors[base_size] = block + (size_t)base_size * dimention;
+        if (!file.read(vectors[base_size], dimention * sizeof(float))) {
             throw std::runtime_error("Error reading vector data from file");
         }
 
         base_size++;
     }
-
-    file.close();
 }
 
 // Initialize vectors with generated values and fill cache
 Vectors::Vectors(int num_vectors, int queries_num) 
     : base_size(num_vectors), dimention(3), queries(queries_num) {
     
-    vectors = new float*[base_size + queries];
-    filters = new float[base_size + queries]();
+    vectors = new float*[base_size + queries]();
+    filters = new LabelSet[base_size + queries];
+    timestamps = new float[base_size + queries]();
+    ranges.resize(queries);
 
     for (int i = 0; i < base_size; i++) {
         vectors[i] = new float[dimention];
-        filters[i] = i % 2;
-        filters_map[filters[i]].insert(i);
+        timestamps[i] = i;
+        Label label = add_label(i % 2);
+        filters[i] = LabelSet(label);
+        postings[label].push_back(i);
         for (int j = 0; j < dimention; j++) {
             vectors[i][j] = static_cast<float>(i * 3 + (j + 1)); 
         }
@@ -59,25 +70,226 @@ Vectors::Vectors(int num_vectors, int queries_num)
 
 // Destructor to free allocated memory
 Vectors::~Vectors() {
-    for (int i = 0; i < base_size + queries; i++)
-        delete[] vectors[i];
+    for (int i = 0; i < base_size + queries; i++) {
+        if (!in_block(vectors[i])) delete[] vectors[i];
+    }
+    for (const auto& block : blocks) huge_free(block.first, block.second);
     delete[] vectors;
     delete[] filters;
+    delete[] timestamps;
 }
 
-// Calculate Euclidean distance between two vectors
-float Vectors::euclidean_distance(int index1, int index2) {
-    const float *a = vectors[index1];
-    const float *b = vectors[index2];
+// Allocate a region for the values of 'count' vectors, on huge pages if they are enabled
+float *Vectors::allocate_block(int count) {
+    size_t bytes = (size_t)count * dimention * sizeof(float);
+    float *block = static_cast<float*>(huge_alloc(bytes));
+    if (block == nullptr) throw std::bad_alloc();
+    blocks.push_back({block, bytes});
+    return block;
+}
+
+// Check if 'values' lie in one of the regions of allocate_block()
+bool Vectors::in_block(const float *values) const {
+    for (const auto& block : blocks) {
+        if (values >= block.first && values < block.first + block.second / sizeof(float)) return true;
+    }
+    return false;
+}
+
+// Make room for 'count' more base vectors. Queries are moved so that they always follow the base vectors
+void Vectors::grow(int count) {
+    float **new_vectors = new float*[base_size + count + queries]();
+    LabelSet *new_filters = new LabelSet[base_size + count + queries];
+    float *new_timestamps = new float[base_size + count + queries]();
+
+    // Base vectors keep their indexes, while queries are shifted by 'count' positions
+    std::copy(vectors, vectors + base_size, new_vectors);
+    std::move(filters, filters + base_size, new_filters);
+    std::copy(timestamps, timestamps + base_size, new_timestamps);
+    std::copy(vectors + base_size, vectors + base_size + queries, new_vectors + base_size + count);
+    std::move(filters + base_size, filters + base_size + queries, new_filters + base_size + count);
+
+    // Only the arrays of pointers are re-allocated, the vectors' data are not copied
+    delete[] vectors;
+    delete[] filters;
+    delete[] timestamps;
+    vectors = new_vectors;
+    filters = new_filters;
+    timestamps = new_timestamps;
+}
+
+// Append a new base vector with the given filter, growing the dataset by one
+int Vectors::add_vector(const float *values, float filter, float timestamp) {
+    grow(1);
+
+    vectors[base_size] = new float[dimention];
+    std::memcpy(vectors[base_size], values, dimention * sizeof(float));
+    rotate(vectors[base_size]);
+    Label label = add_label(filter);
+    filters[base_size] = LabelSet(label);
+    postings[label].push_back(base_size);
+    timestamps[base_size] = timestamp;
+
+    return base_size++;
+}
+
+// Overwrite the base vector at 'index' with new values and filter (used when reusing the slot of a deleted vector)
+void Vectors::set_vector(int index, const float *values, float filter, float timestamp) {
+    ERROR_EXIT(index < 0 || index >= base_size, "Invalid vector index")
+
+    std::memcpy(vectors[index], values, dimention * sizeof(float));
+    rotate(vectors[index]);
+    timestamps[index] = timestamp;
+
+    // Move the index to the posting list of its new label, keeping it sorted
+    remove_posting(index);
+    filters[index] = LabelSet();
+    add_filter(index, filter);
+}
+
+// Add the label of a filter value to the base vector at 'index', keeping its posting list sorted
+void Vectors::add_filter(int index, float value) {
+    Label label = add_label(value);
+    if (filters[index].contains(label)) return;
+
+    filters[index].insert(label);
+    std::vector<int>& posting = postings[label];
+    posting.insert(std::lower_bound(posting.begin(), posting.end(), index), index);
+}
 
+// Load extra labels of the base vectors from a file
+void Vectors::read_labels(const std::string& file_name) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    u_int32_t u_num_vectors;
+    if (!file.read(reinterpret_cast<char*>(&u_num_vectors), sizeof(u_num_vectors))) return;
+    int num_vectors = std::min(static_cast<int>(u_num_vectors), base_size);
+
+    // Labels are appended to the posting lists, which are sorted once at the end
+    for (int i = 0; i < num_vectors; i++) {
+        u_int32_t count;
+        if (!file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+            throw std::runtime_error("Error reading labels from file");
+        }
+        std::vector<float> values(count);
+        if (!file.read(reinterpret_cast<char*>(values.data()), count * sizeof(float))) {
+            throw std::runtime_error("Error reading labels from file");
+        }
+
+        for (float value : values) {
+            Label label = add_label(value);
+            if (filters[i].contains(label)) continue;
+            filters[i].insert(label);
+            postings[label].push_back(i);
+        }
+    }
+    for (auto& posting : postings) std::sort(posting.begin(), posting.end());
+
+    file.close();
+}
+
+// Returns the label of a filter value, assigning a new label (with an empty posting list) if the value is new
+Label Vectors::add_label(float value) {
+    auto it = label_ids.find(value);
+    if (it != label_ids.end()) return it->second;
+
+    Label label = label_values.size();
+    label_ids[value] = label;
+    label_values.push_back(value);
+    postings.emplace_back();
+    return label;
+}
+
+// Returns the label of a filter value. Value -1 maps to NO_LABEL and values that have not been seen to UNKNOWN_LABEL
+Label Vectors::find_label(float value) const {
+    if (value == -1) return NO_LABEL;
+    auto it = label_ids.find(value);
+    return it != label_ids.end() ? it->second : UNKNOWN_LABEL;
+}
+
+// Remove the base vector at 'index' from the posting lists of its labels
+void Vectors::remove_posting(int index) {
+    for (Label label : filters[index].labels()) {
+        if (label >= postings.size()) continue;
+
+        std::vector<int>& posting = postings[label];
+        auto it = std::lower_bound(posting.begin(), posting.end(), index);
+        if (it != posting.end() && *it == index) posting.erase(it);
+    }
+}
+
+// Append (copies of) the base vectors of 'other', starting from index 'from', growing the dataset only once
+int Vectors::append_vectors(const Vectors& other, int from) {
+    ERROR_EXIT(other.dimension() != dimention, "Vectors' dimensions do not match")
+    int count = other.size() - from;
+    if (count <= 0) return 0;
+
+    grow(count);
+    float *block = allocate_block(count);
+    for (int i = from; i < other.size(); i++) {
+        vectors[base_size] = block + (size_t)(i - from) * dimention;
+        std::memcpy(vectors[base_size], other[i], dimention * sizeof(float));
+        rotate(vectors[base_size]);
+        timestamps[base_size] = other.timestamps[i];
+        // Labels of 'other' are mapped back to filter values, since the two objects assign labels independently
+        for (Label other_label : other.filters[i].labels()) {
+            Label label = add_label(other.label_values[other_label]);
+            filters[base_size].insert(label);
+            postings[label].push_back(base_size);
+        }
+        base_size++;
+    }
+
+    return count;
+}
+
+// Sort the base vectors by timestamp (ties by index)
+void Vectors::build_time_index() {
+    time_index.resize(base_size);
+    for (int i = 0; i < base_size; i++) time_index[i] = i;
+    std::sort(time_index.begin(), time_index.end(), [&](int i, int j) {
+        return timestamps[i] < timestamps[j] || (timestamps[i] == timestamps[j] && i < j);
+    });
+}
+
+// Returns the positions [first, last) of 'time_index' whose vectors have a timestamp in 'range'
+std::pair<int, int> Vectors::time_index_bounds(const TimeRange& range) const {
+    auto first = std::lower_bound(time_index.begin(), time_index.end(), range.from, [&](int i, float t) {
+        return timestamps[i] < t;
+    });
+    auto last = std::upper_bound(first, time_index.end(), range.to, [&](float t, int i) {
+        return t < timestamps[i];
+    });
+    return {first - time_index.begin(), last - time_index.begin()};
+}
+
+// Sum of the 8 floats of 'v'
+static inline float horizontal_sum(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_hadd_ps(sum, sum);
+    sum = _mm_hadd_ps(sum, sum);
+    return _mm_cvtss_f32(sum);
+}
+
+// Squared Euclidean distance of two arrays of 'dimension' floats, using AVX
+// If 'bounded' is set, the sum is checked after every block of DISTANCE_BLOCK dimensions and returned as soon as it
+// exceeds 'bound'. The check does not change the order of the additions, so complete distances are the same either way
+template <bool bounded>
+static inline float squared_distance(const float *a, const float *b, int dimension, float bound = 0) {
     __m256 sum_vec = _mm256_setzero_ps(); // Accumulator for the sum of squared differences
     int i;
-    for (i = 0; i <= dimention - 8; i += 8) {
+    for (i = 0; i <= dimension - 8; i += 8) {
         __m256 vec_a = _mm256_loadu_ps(a + i);      // Load 8 floats from vector a
         __m256 vec_b = _mm256_loadu_ps(b + i);      // Load 8 floats from vector b
         __m256 diff = _mm256_sub_ps(vec_a, vec_b);  // Compute a[i]-b[i]
         __m256 sq_diff = _mm256_mul_ps(diff, diff); // Square the differences
         sum_vec = _mm256_add_ps(sum_vec, sq_diff);
+
+        if (bounded && (i + 8) % DISTANCE_BLOCK == 0) {
+            float partial = horizontal_sum(sum_vec);
+            if (partial > bound) return partial;
+        }
     }
     // Sum the SIMD register into a single sum variable
     float sum_array[8];
@@ -86,7 +298,7 @@ float Vectors::euclidean_distance(int index1, int index2) {
     for (int j = 0; j < 8; j++)
         sum += sum_array[j];
     // Handle the remaining (possible) elements
-    for (; i < dimention; i++) {
+    for (; i < dimension; i++) {
         float diff = a[i] - b[i];
         sum += diff * diff;
     }
@@ -94,75 +306,182 @@ float Vectors::euclidean_distance(int index1, int index2) {
     return sum;
 }
 
-// Load multiple query vectors from a file
-void Vectors::read_queries(const std::string& file_name, int read_num) {
-    std::ifstream file(file_name, std::ios::binary);
-    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+// Calculate Euclidean distance between two vectors
+float Vectors::euclidean_distance(int index1, int index2) {
+    STATS_ADD(distances, 1);
+    return squared_distance<false>(vectors[index1], vectors[index2], dimention);
+}
 
-    // Read the number of queries
-    u_int32_t u_queries_num;
-    if (!file.read(reinterpret_cast<char*>(&u_queries_num), sizeof(u_queries_num))) return;
-    int queries_num = std::min(static_cast<int>(u_queries_num), read_num);
+// Calculate Euclidean distance between a vector that is not stored (e.g. a centroid) and the vector at 'index'
+float Vectors::euclidean_distance(const float *values, int index) const {
+    STATS_ADD(distances, 1);
+    return squared_distance<false>(values, vectors[index], dimention);
+}
+
+// Calculate Euclidean distance between two vectors, abandoning it once it exceeds 'bound'
+float Vectors::euclidean_distance(int index1, int index2, float bound) {
+    STATS_ADD(distances, 1);
+    float distance = squared_distance<true>(vectors[index1], vectors[index2], dimention, bound);
+    STATS_ADD(abandoned, distance > bound);
+    return distance;
+}
+
+// Eigen decomposition of the symmetric d x d matrix 'A' (row major) with the cyclic Jacobi method. 'A' is diagonalized
+// in place, so its diagonal holds the eigenvalues at the end, and the eigenvectors are stored as the columns of 'V'
+static void jacobi_eigen(std::vector<double>& A, std::vector<double>& V, int d) {
+    V.assign((size_t)d * d, 0.0);
+    for (int i = 0; i < d; i++) V[(size_t)i * d + i] = 1.0;
+
+    double norm = 0.0;
+    for (double value : A) norm += value * value;
+
+    for (int sweep = 0; sweep < 100; sweep++) {
+        double off = 0.0;
+        for (int p = 0; p < d; p++)
+            for (int q = p + 1; q < d; q++) off += A[(size_t)p * d + q] * A[(size_t)p * d + q];
+        if (off <= 1e-24 * norm) break;
+
+        for (int p = 0; p < d; p++) {
+            for (int q = p + 1; q < d; q++) {
+                double apq = A[(size_t)p * d + q];
+                if (apq == 0.0) continue;
 
-    int num_read_vectors = base_size;
+                // Rotation by the angle that zeroes A[p][q]
+                double theta = (A[(size_t)q * d + q] - A[(size_t)p * d + p]) / (2 * apq);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+                double c = 1 / std::sqrt(t * t + 1), s = t * c;
 
-    while (num_read_vectors < base_size + queries_num && file) {
-        // Determine the type of the query
-        float type;
-        if (!file.read(reinterpret_cast<char*>(&type), sizeof(float))) break;
-        if (type > 1) { // Ignore it if it is a timestamp query
-            file.seekg(103*sizeof(float), std::ios::cur);
-            continue;
+                for (int k = 0; k < d; k++) {
+                    double akp = A[(size_t)k * d + p], akq = A[(size_t)k * d + q];
+                    A[(size_t)k * d + p] = c * akp - s * akq;
+                    A[(size_t)k * d + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < d; k++) {
+                    double apk = A[(size_t)p * d + k], aqk = A[(size_t)q * d + k];
+                    A[(size_t)p * d + k] = c * apk - s * aqk;
+                    A[(size_t)q * d + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < d; k++) {
+                    double vkp = V[(size_t)k * d + p], vkq = V[(size_t)k * d + q];
+                    V[(size_t)k * d + p] = c * vkp - s * vkq;
+                    V[(size_t)k * d + q] = s * vkp + c * vkq;
+                }
+            }
         }
+    }
+}
 
-        if (!file.read(reinterpret_cast<char*>(&filters[num_read_vectors]), sizeof(float))) break;
+// Multiply 'values' with the rotation, if there is one
+void Vectors::rotate(float *values) const {
+    if (rotation.empty()) return;
 
-        // Ignore the timestamp related values
-        file.seekg(2*sizeof(float), std::ios::cur);
+    thread_local std::vector<float> original;
+    original.assign(values, values + dimention);
+    for (int r = 0; r < dimention; r++) {
+        const float *row = &rotation[(size_t)r * dimention];
+        float sum = 0.0;
+        for (int k = 0; k < dimention; k++) sum += row[k] * original[k];
+        values[r] = sum;
+    }
+}
 
-        // Read the queries' values
-        vectors[num_read_vectors] = new float[dimention];
-        if (!file.read(reinterpret_cast<char*>(vectors[num_read_vectors]), dimention * sizeof(float))) {
-            throw std::runtime_error("Error reading vector data from file");
+// Rotate every vector to the principal components of (a sample of) the base vectors
+void Vectors::pca_rotate() {
+    if (base_size == 0) return;
+    int d = dimention, step = std::max(1, base_size / PCA_SAMPLE);
+
+    // Covariance matrix of every step-th base vector
+    std::vector<double> mean(d, 0.0), covariance((size_t)d * d, 0.0);
+    int count = 0;
+    for (int i = 0; i < base_size; i += step, count++) {
+        for (int j = 0; j < d; j++) mean[j] += vectors[i][j];
+    }
+    for (int j = 0; j < d; j++) mean[j] /= count;
+
+    std::vector<double> centered(d);
+    for (int i = 0; i < base_size; i += step) {
+        for (int j = 0; j < d; j++) centered[j] = vectors[i][j] - mean[j];
+        for (int a = 0; a < d; a++)
+            for (int b = a; b < d; b++) covariance[(size_t)a * d + b] += centered[a] * centered[b];
+    }
+    for (int a = 0; a < d; a++) {
+        for (int b = a; b < d; b++) {
+            covariance[(size_t)a * d + b] /= count;
+            covariance[(size_t)b * d + a] = covariance[(size_t)a * d + b];
         }
+    }
+
+    // The rows of the rotation are the eigenvectors, in descending eigenvalue (variance)
+    std::vector<double> eigenvectors;
+    jacobi_eigen(covariance, eigenvectors, d);
+    std::vector<int> order(d);
+    for (int j = 0; j < d; j++) order[j] = j;
+    std::sort(order.begin(), order.end(), [&](int x, int y) {
+        return covariance[(size_t)x * d + x] > covariance[(size_t)y * d + y];
+    });
 
-        num_read_vectors++;
+    rotation.resize((size_t)d * d);
+    for (int r = 0; r < d; r++)
+        for (int k = 0; k < d; k++) rotation[(size_t)r * d + k] = eigenvectors[(size_t)k * d + order[r]];
+
+    // Query slots that have not been filled yet are rotated when they are set
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < base_size + queries; i++) {
+        if (vectors[i] != nullptr) rotate(vectors[i]);
+    }
+}
+
+// Store a query record (type, filter, timestamp range and values) in query slot 'slot', reusing the slot's memory
+// Timestamp queries (types 2 and 3) are not stored, unless 'range_queries' is set. Returns true if the query was stored
+bool Vectors::set_query(int slot, const float *record, bool range_queries) {
+    float type = record[0];
+    if (type > 1 && !range_queries) return false;
+
+    // Type 2 queries only have a timestamp range
+    int index = base_size + slot;
+    Label label = type != 2 ? find_label(record[1]) : NO_LABEL;
+    filters[index] = label != NO_LABEL ? LabelSet(label) : LabelSet();
+    ranges[slot] = type > 1 ? TimeRange{record[2], record[3]} : TimeRange();
+
+    if (vectors[index] == nullptr) vectors[index] = new float[dimention];
+    std::memcpy(vectors[index], record + QUERY_HEADER, dimention * sizeof(float));
+    rotate(vectors[index]);
+    return true;
+}
+
+// Load queries from a file. Timestamp queries (types 2 and 3) are skipped, unless 'range_queries' is set
+void Vectors::read_queries(const std::string& file_name, int read_num, bool range_queries) {
+    std::ifstream file(file_name, std::ios::binary);
+    if (!file) throw std::runtime_error("Error opening file: " + file_name);
+
+    // Read the number of queries
+    u_int32_t u_queries_num;
+    if (!file.read(reinterpret_cast<char*>(&u_queries_num), sizeof(u_queries_num))) return;
+    int queries_num = std::min(static_cast<int>(u_queries_num), read_num);
+
+    std::vector<float> record(QUERY_HEADER + dimention);
+    int slot = 0;
+    while (slot < queries_num && file.read(reinterpret_cast<char*>(record.data()), record.size() * sizeof(float))) {
+        if (set_query(slot, record.data(), range_queries)) slot++;
     }
     file.close();
 }
 
 // Load the query of the given index from a file
-bool Vectors::read_query(const std::string& file_name, int index) {
+bool Vectors::read_query(const std::string& file_name, int index, bool range_queries) {
     std::ifstream file(file_name, std::ios::binary);
     if (!file) throw std::runtime_error("Error opening file: " + file_name);
     
     int queries_num;
     if (!file.read(reinterpret_cast<char*>(&queries_num), sizeof(int))) return false;
-    if (index < queries_num) {
-        file.seekg((104 * index)*sizeof(float), std::ios::cur);
-    } else {
-        return false;
-    }
+    if (index >= queries_num) return false;
 
-    float type;
-    if (!file.read(reinterpret_cast<char*>(&type), sizeof(float))) return false;
-    if (type > 1) { // Ignore it if it is a timestamp query
-        return false;
-    }
-
-    if (!file.read(reinterpret_cast<char*>(&filters[base_size]), sizeof(float))) return false;
-
-    // Ignore the timestamp related values
-    file.seekg(2*sizeof(float), std::ios::cur);
-
-    // Read the queries' values
-    vectors[base_size] = new float[dimention];
-    if (!file.read(reinterpret_cast<char*>(vectors[base_size]), dimention * sizeof(float))) {
-        throw std::runtime_error("Error reading vector data from file");
-    }
+    std::vector<float> record(QUERY_HEADER + dimention);
+    file.seekg(index * record.size() * sizeof(float), std::ios::cur);
+    if (!file.read(reinterpret_cast<char*>(record.data()), record.size() * sizeof(float))) return false;
     
     file.close();
-    return true;
+    return set_query(0, record.data(), range_queries);
 }
 
 // Return the indices of the k-nearest neighboors of the given index 
@@ -187,4 +506,5 @@ std::vector<int> Vectors::query_solutions(const std::string& file_name, int quer
 void Vectors::add_query(float *values) {
     vectors[base_size] = new float[dimention];
     std::memcpy(vectors[base_size], values, dimention * sizeof(float));
+    rotate(vectors[base_size]);
 }
\ No newline at end of file
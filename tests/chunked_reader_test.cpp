@@ -0,0 +1,74 @@
+#include "acutest.h"               // Acutest testing framework
+#include "chunked_reader.hpp"      // ChunkedReader class
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// Write 'count' consecutive integers to a file
+static void write_integers(const char *file_name, int count) {
+    std::ofstream file(file_name, std::ios::binary);
+    for (int i = 0; i < count; i++) file.write(reinterpret_cast<const char*>(&i), sizeof(i));
+}
+
+// Read the integers back with reads of varying sizes, which cross the chunk boundaries
+static void check_read(bool use_io_uring) {
+    const int count = 10000;
+    write_integers("chunked-reader-test.bin", count);
+    {
+        // Small chunks, so that the file takes many of them
+        ChunkedReader reader("chunked-reader-test.bin", 4096, use_io_uring);
+        if (!use_io_uring) TEST_CHECK(!reader.uses_io_uring());
+
+        int next = 0, size = 1;
+        std::vector<int> values;
+        while (next < count) {
+            size = std::min(size % 700 + 1, count - next);
+            values.resize(size);
+            TEST_CHECK(reader.read(values.data(), size * sizeof(int)));
+            for (int i = 0; i < size; i++) TEST_CHECK(values[i] == next + i);
+            next += size;
+        }
+
+        // The file has ended
+        int value;
+        TEST_CHECK(!reader.read(&value, sizeof(value)));
+    }
+    std::remove("chunked-reader-test.bin");
+}
+
+// Test for reads through io_uring (or pread() if the kernel does not allow it)
+void test_chunked_reader_io_uring(void) {
+    check_read(true);
+}
+
+// Test for reads through pread()
+void test_chunked_reader_pread(void) {
+    check_read(false);
+}
+
+// Test for a read that asks for more bytes than the file has left
+void test_chunked_reader_end(void) {
+    write_integers("chunked-reader-test.bin", 3);
+    {
+        ChunkedReader reader("chunked-reader-test.bin");
+        int values[4];
+        TEST_CHECK(!reader.read(values, sizeof(values)));
+    }
+    {
+        ChunkedReader reader("chunked-reader-test.bin");
+        int values[3];
+        TEST_CHECK(reader.read(values, sizeof(values)));
+        TEST_CHECK(values[0] == 0 && values[2] == 2);
+    }
+    std::remove("chunked-reader-test.bin");
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_chunked_reader_io_uring", test_chunked_reader_io_uring },
+    { "test_chunked_reader_pread", test_chunked_reader_pread },
+    { "test_chunked_reader_end", test_chunked_reader_end },
+    { NULL, NULL }
+};
@@ -0,0 +1,86 @@
+#include "acutest.h"               // Acutest testing framework
+#include "compressed_graph.hpp"    // CompressedGraph class
+#include "filtered_greedy_search.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+// Test that values of every byte length are decoded back, for counts that are not multiples of 4 as well
+void test_stream_vbyte(void) {
+    std::vector<uint32_t> values;
+    for (int i = 0; i < 103; i++) values.push_back((uint32_t)i * 2654435761u >> (i % 32));
+
+    for (size_t count : {0, 1, 3, 4, 5, 64, 103}) {
+        std::vector<uint8_t> encoded((count + 3) / 4 + 4 * count + 16);
+        size_t bytes = stream_vbyte_encode(values.data(), count, encoded.data());
+        TEST_CHECK(bytes <= (count + 3) / 4 + 4 * count);
+
+        std::vector<uint32_t> decoded(count);
+        stream_vbyte_decode(encoded.data(), count, decoded.data());
+        TEST_CHECK(std::equal(decoded.begin(), decoded.end(), values.begin()));
+    }
+
+    // Small values take a single byte
+    uint32_t small[] = {1, 2, 3, 4};
+    uint8_t encoded[5 + 16];
+    TEST_CHECK(stream_vbyte_encode(small, 4, encoded) == 5);
+}
+
+// Creates a sample directed graph with sequential and near-sequential edges, and some long ones
+static DirectedGraph *create_graph(int num) {
+    DirectedGraph *graph = new DirectedGraph(num);
+    for (int i = 0; i < num - 4; i++) {
+        graph->insert(i, i + 2);
+        graph->insert(i, i + 4);
+        graph->insert(i, (i * 7919 + 3) % num == i ? (i + 1) % num : (i * 7919 + 3) % num);
+    }
+    return graph;
+}
+
+// Test that the neighbor lists are the same, in ascending order
+void test_compressed_graph_neighbors(void) {
+    DirectedGraph *graph = create_graph(1000);
+    graph->mark_deleted(10);
+    CompressedGraph compressed(*graph);
+
+    TEST_CHECK(compressed.get_size() == 1000);
+    TEST_CHECK(compressed.is_deleted(10) && !compressed.is_deleted(11));
+
+    size_t edges = 0;
+    for (int v = 0; v < 1000; v++) {
+        std::vector<int> expected(graph->get_neighbors(v).begin(), graph->get_neighbors(v).end());
+        std::sort(expected.begin(), expected.end());
+        TEST_CHECK(compressed.get_neighbors(v) == expected);
+        edges += expected.size();
+    }
+    TEST_CHECK(compressed.edges() == edges);
+    TEST_CHECK(compressed.memory() < compressed.flat_memory());
+    delete graph;
+}
+
+// Test that searches on the compressed graph return the same results
+void test_compressed_graph_search(void) {
+    Vectors vectors(1000, 1);
+    DirectedGraph *graph = create_graph(1000);
+    CompressedGraph compressed(*graph);
+
+    float query_values[] = {3000, 2000, 1000};
+    vectors.add_query(query_values);
+
+    auto result = FilteredGreedySearch(compressed, vectors, 0, 1000, 5, 10, std::numeric_limits<int>::max());
+    TEST_CHECK(!result.first.empty());
+    TEST_CHECK(result.first == FilteredGreedySearch(*graph, vectors, 0, 1000, 5, 10, std::numeric_limits<int>::max()).first);
+
+    auto unfiltered = UnfilteredGreedySearch(compressed, vectors, {0, 1}, 1000, 5, 10, std::numeric_limits<int>::max());
+    TEST_CHECK(unfiltered.first == UnfilteredGreedySearch(*graph, vectors, {0, 1}, 1000, 5, 10, std::numeric_limits<int>::max()).first);
+    delete graph;
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_stream_vbyte", test_stream_vbyte },
+    { "test_compressed_graph_neighbors", test_compressed_graph_neighbors },
+    { "test_compressed_graph_search", test_compressed_graph_search },
+    { NULL, NULL }
+};
@@ -171,11 +171,80 @@ void test_directed_graph_get_neighbors(void) {
     delete g;
 }
 
+void test_directed_graph_resize(void) {
+    // Create edges as follows: 0->1, 1->2, ..., (NUM_OF_ENTRIES-2)->(NUM_OF_ENTRIES-1)
+    DirectedGraph *g = new DirectedGraph(NUM_OF_ENTRIES);
+    for (int i = 0 ; i < NUM_OF_ENTRIES - 1 ; i++) {
+        g->insert(i, i + 1);
+    }
+
+    // Double the graph's size
+    g->resize(2 * NUM_OF_ENTRIES);
+    TEST_CHECK(g->get_size() == 2 * NUM_OF_ENTRIES);
+
+    // Old edges must be kept
+    for (int i = 0 ; i < NUM_OF_ENTRIES - 1 ; i++) {
+        const auto& neighbors = g->get_neighbors(i);
+        TEST_CHECK(neighbors.size() == 1);
+        TEST_CHECK(neighbors.find(i + 1) != neighbors.end());
+    }
+
+    // New vertices must have no edges and must be usable
+    for (int i = NUM_OF_ENTRIES ; i < 2 * NUM_OF_ENTRIES ; i++) {
+        TEST_CHECK(g->get_neighbors(i).empty());
+    }
+    g->insert(2 * NUM_OF_ENTRIES - 1, 0);
+    TEST_CHECK(g->get_neighbors(2 * NUM_OF_ENTRIES - 1).size() == 1);
+
+    delete g;
+}
+
+void test_directed_graph_delete(void) {
+    // Each vertex points to the next one
+    DirectedGraph *g = new DirectedGraph(NUM_OF_ENTRIES);
+    for (int i = 0 ; i < NUM_OF_ENTRIES - 1 ; i++) {
+        g->insert(i, i + 1);
+    }
+
+    // No vertex is deleted or free initially
+    TEST_CHECK(g->get_tombstones().empty());
+    TEST_CHECK(g->reuse_vertex() == -1);
+
+    // Tombstone every 10th vertex (twice, which must have no effect)
+    for (int i = 0 ; i < NUM_OF_ENTRIES ; i += 10) {
+        g->mark_deleted(i);
+        g->mark_deleted(i);
+    }
+    TEST_CHECK((int)g->get_tombstones().size() == NUM_OF_ENTRIES / 10);
+    for (int i = 0 ; i < NUM_OF_ENTRIES ; i++) {
+        TEST_CHECK(g->is_deleted(i) == (i % 10 == 0));
+    }
+
+    // Tombstoned vertices keep their edges until they are freed
+    TEST_CHECK(g->get_neighbors(10).size() == 1);
+    g->free_tombstones();
+    TEST_CHECK(g->get_tombstones().empty());
+    TEST_CHECK((int)g->get_free_vertices().size() == NUM_OF_ENTRIES / 10);
+    TEST_CHECK(g->get_neighbors(10).empty());
+    TEST_CHECK(g->is_deleted(10));
+
+    // Every freed vertex can be reused exactly once
+    for (int i = 0 ; i < NUM_OF_ENTRIES / 10 ; i++) {
+        Vertex v = g->reuse_vertex();
+        TEST_CHECK(v % 10 == 0 && !g->is_deleted(v));
+    }
+    TEST_CHECK(g->reuse_vertex() == -1);
+
+    delete g;
+}
+
 TEST_LIST = {
     { "test_directed_graph_init", test_directed_graph_init },
     { "test_directed_graph_insert", test_directed_graph_insert },
     { "test_directed_graph_remove", test_directed_graph_remove },
     { "test_directed_graph_stitch", test_directed_graph_stitch },
     { "test_directed_graph_get_neighbors", test_directed_graph_get_neighbors },
+    { "test_directed_graph_resize", test_directed_graph_resize },
+    { "test_directed_graph_delete", test_directed_graph_delete },
     { NULL, NULL } // Terminate test list with NULL
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "acutest.h"               // Acutest testing framework
+#include "disk_index.hpp"          // DiskIndex class
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+// Creates a graph with sequential and near-sequential edges, with the even and the odd vertices disconnected
+static DirectedGraph *create_graph(int num) {
+    DirectedGraph *graph = new DirectedGraph(num);
+    for (int i = 0; i < num - 4; i++) {
+        graph->insert(i, i + 2);
+        graph->insert(i, i + 4);
+    }
+    return graph;
+}
+
+// Writes the disk index of the test vectors (labels 0 and 1 for the even and the odd points) and the graph
+static void write_index(DirectedGraph& graph) {
+    Vectors vectors(1000, 0);
+    std::vector<int> M = {0, 1};
+    write_disk_index(graph, vectors, &M, "disk-index-test.bin");
+}
+
+// Test that the header and the labels are read back
+void test_disk_index_read(void) {
+    DirectedGraph *graph = create_graph(1000);
+    write_index(*graph);
+    {
+        DiskIndex index("disk-index-test.bin");
+        TEST_CHECK(index.size() == 1000);
+        TEST_CHECK(index.dimension() == 3);
+        TEST_CHECK(index.find_label(0) == 0);
+        TEST_CHECK(index.find_label(1) == 1);
+        TEST_CHECK(index.find_label(-1) == NO_LABEL);
+        TEST_CHECK(index.find_label(7) == UNKNOWN_LABEL);
+        // Every node holds its 3 values, its degree and 2 neighbors
+        TEST_CHECK(index.node_bytes() == 1000 * 6 * sizeof(float));
+    }
+    std::remove("disk-index-test.bin");
+    delete graph;
+}
+
+// Test for unfiltered and filtered searches, which must find the exact nearest neighbors
+void test_disk_index_search(void) {
+    DirectedGraph *graph = create_graph(1000);
+    write_index(*graph);
+    {
+        DiskIndex index("disk-index-test.bin");
+        float query[] = {3000, 2000, 1000};
+
+        // Unfiltered queries search from the start nodes of both components
+        long reads = 0;
+        std::vector<int> result = index.search(query, LabelSet(), 5, 10, DISK_BEAM_WIDTH, &reads);
+        TEST_CHECK(result.size() == 5);
+        TEST_CHECK(result[0] == 666);
+        std::sort(result.begin(), result.end());
+        for (int i = 0; i < 5; i++) TEST_CHECK(result[i] == 664 + i);
+        TEST_CHECK(reads > 0);
+
+        // Only odd points have label 1
+        result = index.search(query, LabelSet(index.find_label(1)), 4, 10, 1);
+        std::sort(result.begin(), result.end());
+        TEST_CHECK((result == std::vector<int>{663, 665, 667, 669}));
+
+        // A filter that no point has finds nothing
+        TEST_CHECK(index.search(query, LabelSet(UNKNOWN_LABEL), 4, 10, 1).empty());
+    }
+    std::remove("disk-index-test.bin");
+    delete graph;
+}
+
+// Test that reading the beam through io_uring and with pread() finds the same points
+void test_disk_index_io_uring(void) {
+    DirectedGraph *graph = create_graph(1000);
+    write_index(*graph);
+    {
+        DiskIndex ring_index("disk-index-test.bin"), pread_index("disk-index-test.bin", false);
+        TEST_CHECK(ring_index.reads_direct() == pread_index.reads_direct());
+        float query[] = {3000, 2000, 1000};
+        for (int beam_width : {1, DISK_BEAM_WIDTH, DISK_RING_ENTRIES + 1}) {
+            long ring_reads = 0, pread_reads = 0;
+            std::vector<int> result = ring_index.search(query, LabelSet(), 5, 100, beam_width, &ring_reads);
+            TEST_CHECK(result == pread_index.search(query, LabelSet(), 5, 100, beam_width, &pread_reads));
+            TEST_CHECK(ring_reads == pread_reads);
+            TEST_CHECK(result[0] == 666);
+        }
+    }
+    std::remove("disk-index-test.bin");
+    delete graph;
+}
+
+// Test that deleted points are traversed but never returned
+void test_disk_index_deleted(void) {
+    DirectedGraph *graph = create_graph(1000);
+    graph->mark_deleted(666);
+    write_index(*graph);
+    {
+        DiskIndex index("disk-index-test.bin");
+        float query[] = {3000, 2000, 1000};
+        std::vector<int> result = index.search(query, LabelSet(), 5, 10, DISK_BEAM_WIDTH);
+        TEST_CHECK(result.size() == 5);
+        TEST_CHECK(std::find(result.begin(), result.end(), 666) == result.end());
+        TEST_CHECK(std::find(result.begin(), result.end(), 668) != result.end());
+    }
+    std::remove("disk-index-test.bin");
+    delete graph;
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_disk_index_read", test_disk_index_read },
+    { "test_disk_index_search", test_disk_index_search },
+    { "test_disk_index_io_uring", test_disk_index_io_uring },
+    { "test_disk_index_deleted", test_disk_index_deleted },
+    { NULL, NULL }
+};
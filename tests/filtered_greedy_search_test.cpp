@@ -1,4 +1,5 @@
 #include "acutest.h"         
+#include <algorithm>
 #include <vector>
 #include <iostream> 
 #include <limits>
@@ -38,8 +39,142 @@ void test_filtered_greedy_search(void) {
     TEST_CHECK(result.first[4] == 670);
 }
 
+// Tests the UnfilteredGreedySearch function on a graph with two connected components (even and odd vertices)
+void test_unfiltered_greedy_search(void) {
+    Vectors vectors(1000, 1);
+    DirectedGraph graph = create_graph(1000);
+
+    float query_values[] = {3000, 2000, 1000};
+    vectors.add_query(query_values);
+
+    int k = 5;
+    int L = 10;
+
+    // Seeding with one start node per component must reach the nearest neighbors of both components
+    auto result = UnfilteredGreedySearch(graph, vectors, {0, 1}, 1000, k, L, std::numeric_limits<int>::max());
+    TEST_CHECK(result.first.size() == 5);
+    TEST_CHECK(result.first[0] == 666);
+    std::sort(result.first.begin(), result.first.end());
+    for (int i = 0; i < k; i++) {
+        TEST_CHECK(result.first[i] == 664 + i);
+    }
+
+    // Start node 2 is reached from start node 0, so only the even component is searched
+    result = UnfilteredGreedySearch(graph, vectors, {0, 2}, 1000, k, L, std::numeric_limits<int>::max());
+    TEST_CHECK(result.first.size() == 5);
+    for (auto v : result.first) {
+        TEST_CHECK(v % 2 == 0);
+    }
+}
+
+// Tests that the FilteredGreedySearch only traverses points that share a label with the query
+void test_filtered_greedy_search_labels(void) {
+    Vectors vectors(20, 1);     // Even points have label 0 and odd points label 1
+
+    // Chain 0 -> 1 -> 2 -> ... -> 19
+    DirectedGraph graph(20);
+    for (int i = 0; i < 19; i++) graph.insert(i, i + 1);
+
+    float query_values[] = {100, 100, 100};
+    vectors.add_query(query_values);
+    vectors.filters[20] = LabelSet(0);
+
+    // Point 1 does not have label 0, so the search cannot go further than the start node
+    auto result = FilteredGreedySearch(graph, vectors, 0, 20, 5, 10, std::numeric_limits<int>::max());
+    TEST_CHECK((result.first == std::vector<int>{0}));
+
+    // With labels {0, 1}, point 1 links the start node to point 2, but point 3 does not have label 0
+    vectors.add_filter(1, 0);
+    result = FilteredGreedySearch(graph, vectors, 0, 20, 5, 10, std::numeric_limits<int>::max());
+    TEST_CHECK((result.first == std::vector<int>{2, 1, 0}));
+
+    // Start nodes that do not share a label with the query are ignored
+    result = FilteredGreedySearch(graph, vectors, std::vector<int>{3, 4}, 20, 5, 10, std::numeric_limits<int>::max());
+    TEST_CHECK((result.first == std::vector<int>{4}));
+}
+
+// Tests that the early termination heuristics find the same neighbors on the sample graph, expanding fewer points
+void test_search_termination(void) {
+    Vectors vectors(1000, 1);
+    DirectedGraph graph = create_graph(1000);
+
+    float query_values[] = {3000, 2000, 1000};
+    vectors.add_query(query_values);
+
+    int k = 5, L = 100;
+    auto full = FilteredGreedySearch(graph, vectors, 0, 1000, k, L, std::numeric_limits<int>::max());
+    std::vector<int> expected = {666, 664, 668, 662, 670};
+    TEST_CHECK(full.first == expected);
+
+    // The second result holds every visited point
+    SearchTermination termination;
+    termination.initial_L = k;
+    auto adaptive = FilteredGreedySearch(graph, vectors, std::vector<int>{0}, 1000, k, L, std::numeric_limits<int>::max(), termination);
+    TEST_CHECK(adaptive.first == expected);
+    TEST_CHECK(adaptive.second.size() < full.second.size());
+
+    termination = SearchTermination();
+    termination.epsilon = 0;
+    auto epsilon = FilteredGreedySearch(graph, vectors, std::vector<int>{0}, 1000, k, L, std::numeric_limits<int>::max(), termination);
+    TEST_CHECK(epsilon.first == expected);
+    TEST_CHECK(epsilon.second.size() < full.second.size());
+
+    // The k-th best candidate improves along the path to the query, so the search only stops past the neighbors
+    termination = SearchTermination();
+    termination.patience = 5;
+    auto patience = UnfilteredGreedySearch(graph, vectors, {0}, 1000, k, L, std::numeric_limits<int>::max(), termination);
+    TEST_CHECK(patience.first == expected);
+}
+
+// Tests that searches sharing one set of visited markers find the same neighbors as searches with their own
+void test_reused_visited_set(void) {
+    Vectors vectors(1000, 1);
+    DirectedGraph graph = create_graph(1000);
+
+    float query_values[] = {3000, 2000, 1000};
+    vectors.add_query(query_values);
+
+    int k = 5, L = 10;
+    auto filtered = FilteredGreedySearch(graph, vectors, std::vector<int>{0}, 1000, k, L, std::numeric_limits<int>::max());
+    auto unfiltered = UnfilteredGreedySearch(graph, vectors, {0, 1}, 1000, k, L, std::numeric_limits<int>::max());
+
+    // The markers of every search are cleared by the next one
+    VisitedSet visited;
+    for (int i = 0; i < 3; i++) {
+        auto result = FilteredGreedySearch(graph, vectors, std::vector<int>{0}, 1000, k, L, std::numeric_limits<int>::max(), \
+                                           SearchTermination(), &visited);
+        TEST_CHECK(result.first == filtered.first);
+        TEST_CHECK(result.second == filtered.second);
+        result = UnfilteredGreedySearch(graph, vectors, {0, 1}, 1000, k, L, std::numeric_limits<int>::max(), \
+                                        SearchTermination(), &visited);
+        TEST_CHECK(result.first == unfiltered.first);
+    }
+}
+
+// Tests that a search that does not collect the visited points finds the same neighbors, returning only its L_set
+void test_search_without_visited(void) {
+    Vectors vectors(1000, 1);
+    DirectedGraph graph = create_graph(1000);
+
+    float query_values[] = {3000, 2000, 1000};
+    vectors.add_query(query_values);
+
+    int k = 5, L = 10;
+    auto full = FilteredGreedySearch(graph, vectors, std::vector<int>{0}, 1000, k, L, std::numeric_limits<int>::max());
+    auto neighbors = FilteredGreedySearch(graph, vectors, std::vector<int>{0}, 1000, k, L, std::numeric_limits<int>::max(), \
+                                          SearchTermination(), nullptr, false);
+    TEST_CHECK(neighbors.first == full.first);
+    TEST_CHECK(neighbors.second.size() <= static_cast<size_t>(L));
+    TEST_CHECK(neighbors.second.size() < full.second.size());
+}
+
 // List of tests for the test runner
 TEST_LIST = {
     { "test_filtered_greedy_search", test_filtered_greedy_search },
+    { "test_filtered_greedy_search_labels", test_filtered_greedy_search_labels },
+    { "test_unfiltered_greedy_search", test_unfiltered_greedy_search },
+    { "test_search_termination", test_search_termination },
+    { "test_reused_visited_set", test_reused_visited_set },
+    { "test_search_without_visited", test_search_without_visited },
     { NULL, NULL } 
 };
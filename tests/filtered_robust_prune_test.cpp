@@ -125,9 +125,27 @@ void test_filtered_robust_prune_full_set(void) {
     delete g;
 }
 
+// Test that points are only pruned by points that cover the labels they share with p
+void test_filtered_robust_prune_labels(void) {
+    // Points lie on a line in ascending order. Even points have label 0 and odd points label 1
+    auto vectors = Vectors(4, 0);
+    vectors.add_filter(0, 1);   // Point 0 has labels {0, 1}
+
+    DirectedGraph g(4);
+    std::set<std::pair<float, int>> V;
+    for (int j = 1 ; j < 4 ; j++) V.insert({vectors.euclidean_distance(0, j), j});
+    filtered_robust_prune(&g, vectors, 0, V, A, 3);
+
+    // Point 1 does not have label 0, so it cannot prune point 2. It prunes point 3, since they share label 1
+    const auto& neighbors = g.get_neighbors(0);
+    TEST_CHECK(neighbors.size() == 2);
+    TEST_CHECK(neighbors.count(1) == 1 && neighbors.count(2) == 1);
+}
+
 TEST_LIST = {
     { "test_filtered_robust_prune_general", test_filtered_robust_prune_general },
     { "test_filtered_robust_prune_empty_set", test_filtered_robust_prune_empty_set },
     { "test_filtered_robust_prune_full_set", test_filtered_robust_prune_full_set },
+    { "test_filtered_robust_prune_labels", test_filtered_robust_prune_labels },
     { NULL, NULL } // Terminate test list with NULL
 };
@@ -1,6 +1,8 @@
 #include "acutest.h"
 #include "filtered_vamana.hpp"
+#include "filtered_greedy_search.hpp"
 #include "findmedoid.hpp"
+#include <algorithm>
 #include <limits>
 
 // Used for testing
@@ -30,7 +32,120 @@ void test_filtered_vamana(void) {
     delete g;
 }
 
+void test_filtered_insert_vector(void) {
+    Vectors vectors = Vectors(NUM_OF_ENTRIES, 0);
+
+    auto *M = find_medoid(vectors, T);
+    DirectedGraph *g = filtered_vamana(vectors, A, L, R, M, false, std::numeric_limits<int>::max());
+
+    // Insert a point with an existing filter. It lies between vectors 10 and 11
+    float values[] = {32.5, 33.5, 34.5};
+    int x = filtered_insert_vector(g, vectors, values, 0, A, L, R, M, std::numeric_limits<int>::max());
+    TEST_CHECK(x == NUM_OF_ENTRIES);
+    TEST_CHECK(g->get_size() == NUM_OF_ENTRIES + 1);
+    TEST_CHECK(vectors.size() == NUM_OF_ENTRIES + 1);
+
+    // The new point must be linked, only to points of the same filter
+    const auto& neighbors = g->get_neighbors(x);
+    TEST_CHECK(!neighbors.empty() && neighbors.size() <= R);
+    for (auto v : neighbors) {
+        TEST_CHECK(vectors.filters[v].contains(0));
+    }
+
+    // Insert a point with a new filter, which must become the start node of that filter
+    float new_values[] = {-10.0, -10.0, -10.0};
+    int y = filtered_insert_vector(g, vectors, new_values, 2, A, L, R, M, std::numeric_limits<int>::max());
+    TEST_CHECK(M->size() == 3);
+    TEST_CHECK(M->at(2) == y);
+
+    // Degree limit must hold for every vertex after the insertions
+    for (int i = 0; i < g->get_size(); i++) {
+        TEST_CHECK(g->get_neighbors(i).size() <= R);
+    }
+
+    delete M;
+    delete g;
+}
+
+void test_filtered_consolidate(void) {
+    Vectors vectors = Vectors(NUM_OF_ENTRIES, 1);
+
+    auto *M = find_medoid(vectors, T);
+    DirectedGraph *g = filtered_vamana(vectors, A, L, R, M, false, std::numeric_limits<int>::max());
+
+    // Delete every 3rd point and the start nodes of both filters
+    for (int i = 0; i < NUM_OF_ENTRIES; i += 3) g->mark_deleted(i);
+    int old_start_0 = M->at(0), old_start_1 = M->at(1);
+    g->mark_deleted(old_start_0);
+    g->mark_deleted(old_start_1);
+
+    // Deleted points are still traversed, but never returned
+    float query_values[] = {100, 101, 102};
+    vectors.add_query(query_values);
+    auto result = FilteredGreedySearch(*g, vectors, M->at(0), NUM_OF_ENTRIES, 10, L, std::numeric_limits<int>::max());
+    TEST_CHECK(!result.first.empty());
+    for (auto v : result.first) TEST_CHECK(!g->is_deleted(v));
+    for (auto& pair : result.second) TEST_CHECK(!g->is_deleted(pair.second));
+
+    int deleted = filtered_consolidate(g, vectors, A, R, M);
+    TEST_CHECK(deleted == (int)g->get_free_vertices().size());
+    TEST_CHECK(g->get_tombstones().empty());
+
+    // No remaining vertex may point to a deleted one and the degree limit must hold
+    for (int i = 0; i < NUM_OF_ENTRIES; i++) {
+        const auto& neighbors = g->get_neighbors(i);
+        if (g->is_deleted(i)) TEST_CHECK(neighbors.empty());
+        TEST_CHECK(neighbors.size() <= R);
+        for (auto v : neighbors) TEST_CHECK(!g->is_deleted(v));
+    }
+
+    // Start nodes must have been replaced with points of the same filter
+    TEST_CHECK(!g->is_deleted(M->at(0)) && vectors.filters[M->at(0)].contains(0));
+    TEST_CHECK(!g->is_deleted(M->at(1)) && vectors.filters[M->at(1)].contains(1));
+    TEST_CHECK(!std::binary_search(vectors.postings[0].begin(), vectors.postings[0].end(), old_start_0));
+
+    // New points reuse the freed slots
+    float values[] = {32.5, 33.5, 34.5};
+    int x = filtered_insert_vector(g, vectors, values, 0, A, L, R, M, std::numeric_limits<int>::max());
+    TEST_CHECK(x < NUM_OF_ENTRIES);
+    TEST_CHECK(!g->is_deleted(x) && !g->get_neighbors(x).empty());
+    TEST_CHECK(vectors.size() == NUM_OF_ENTRIES);
+
+    delete M;
+    delete g;
+}
+
+void test_filtered_lazy_consolidate(void) {
+    Vectors vectors = Vectors(NUM_OF_ENTRIES, 1);
+
+    auto *M = find_medoid(vectors, T);
+    DirectedGraph *g = filtered_vamana(vectors, A, L, R, M, false, std::numeric_limits<int>::max());
+
+    // 10 tombstones are fewer than 5% of the points, so they stay until more points are deleted
+    for (int i = 1; i <= 10; i++) g->mark_deleted(i * 7);
+    TEST_CHECK(filtered_lazy_consolidate(g, vectors, A, R, M, 0.05) == 0);
+    TEST_CHECK(g->get_tombstones().size() == 10 && g->get_free_vertices().empty());
+
+    // Tombstoned points are still traversed, but never returned
+    float query_values[] = {70, 71, 72};
+    vectors.add_query(query_values);
+    auto result = FilteredGreedySearch(*g, vectors, M->at(0), NUM_OF_ENTRIES, 10, L, std::numeric_limits<int>::max());
+    TEST_CHECK(!result.first.empty());
+    for (auto v : result.first) TEST_CHECK(!g->is_deleted(v));
+
+    // With 35 tombstones (5%) all of them are consolidated in a single pass
+    for (int i = 11; i <= 35; i++) g->mark_deleted(i * 7);
+    TEST_CHECK(filtered_lazy_consolidate(g, vectors, A, R, M, 0.05) == 35);
+    TEST_CHECK(g->get_tombstones().empty() && g->get_free_vertices().size() == 35);
+
+    delete M;
+    delete g;
+}
+
 TEST_LIST = {
     { "test_filtered_vamana", test_filtered_vamana },
+    { "test_filtered_insert_vector", test_filtered_insert_vector },
+    { "test_filtered_consolidate", test_filtered_consolidate },
+    { "test_filtered_lazy_consolidate", test_filtered_lazy_consolidate },
     { NULL, NULL }
 };
\ No newline at end of file
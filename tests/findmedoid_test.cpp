@@ -27,7 +27,67 @@ void test_find_medoid(void) {
     delete M;
 }
 
+void test_find_medoid_centroid(void) {
+    // Same dataset as above. Points lie on a line, so the point closest to the centroid of each filter is its median
+    Vectors vectors = Vectors(50, 0);
+
+    // A threshold greater than the number of points per filter means that the exact centroid is used
+    auto *M = find_medoid(vectors, 50);
+    TEST_CHECK(M->at(0) == 24);
+    TEST_CHECK(M->at(1) == 25);
+
+    delete M;
+}
+
+void test_find_start_points(void) {
+    Vectors vectors = Vectors(50, 0);
+
+    auto *M = find_start_points(vectors, 50, 3);
+    TEST_CHECK(M->size() == 2);
+
+    for (Label f : {0, 1}) {
+        const auto& start_points = M->at(f);
+        TEST_CHECK(start_points.size() == 3);
+
+        // The first start point is the medoid
+        TEST_CHECK(start_points[0] == (f == 0 ? 24 : 25));
+
+        // Start points must be distinct points of the filter
+        for (int i = 0; i < 3; i++) {
+            TEST_CHECK(vectors.filters[start_points[i]].contains(f));
+            for (int j = i + 1; j < 3; j++) TEST_CHECK(start_points[i] != start_points[j]);
+        }
+    }
+    delete M;
+
+    // No more start points than the points of each filter can be returned
+    M = find_start_points(vectors, 5, 100);
+    TEST_CHECK(M->at(0).size() == 25);
+    TEST_CHECK(M->at(1).size() == 25);
+    delete M;
+
+    // Given medoids (here from a small sample, so they are not always the median) are kept as the first start points
+    auto *medoids = find_medoid(vectors, 3);
+    M = find_start_points(vectors, 5, 3, medoids);
+    for (Label f : {0, 1}) {
+        TEST_CHECK(M->at(f).size() == 3);
+        TEST_CHECK(M->at(f)[0] == medoids->at(f));
+        for (int i = 1; i < 3; i++) TEST_CHECK(M->at(f)[i] != medoids->at(f));
+    }
+    delete M;
+    delete medoids;
+}
+
+void test_find_global_medoid(void) {
+    // Points lie on a line, so the point closest to the centroid of all points is their median
+    Vectors vectors = Vectors(51, 0);
+    TEST_CHECK(find_global_medoid(vectors, 51) == 25);
+}
+
 TEST_LIST = {
     { "test_find_medoid", test_find_medoid },
+    { "test_find_medoid_centroid", test_find_medoid_centroid },
+    { "test_find_start_points", test_find_start_points },
+    { "test_find_global_medoid", test_find_global_medoid },
     { NULL, NULL }
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "acutest.h"               // Acutest testing framework
+#include "huge_pages.hpp"          // Huge page allocations
+#include "vectors.hpp"             // Vectors class
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// Test that regions are zeroed and writable, and large ones aligned to a huge page, with and without huge pages
+void test_huge_alloc(void) {
+    for (bool enable : {false, true}) {
+        set_huge_pages(enable);
+        TEST_CHECK(huge_pages_enabled() == enable);
+
+        for (size_t bytes : {(size_t)100, HUGE_PAGE_SIZE, 3 * HUGE_PAGE_SIZE + 5}) {
+            PageBacking backing;
+            char *memory = static_cast<char*>(huge_alloc(bytes, &backing));
+            TEST_ASSERT(memory != nullptr);
+            TEST_CHECK(memory[0] == 0 && memory[bytes - 1] == 0);
+            memory[0] = memory[bytes - 1] = 1;
+
+            if (bytes >= HUGE_PAGE_SIZE) TEST_CHECK(reinterpret_cast<uintptr_t>(memory) % HUGE_PAGE_SIZE == 0);
+            // Without huge pages, or for small regions, pages are always the normal ones
+            if (!enable || bytes < HUGE_PAGE_SIZE) TEST_CHECK(backing == PageBacking::NORMAL);
+            huge_free(memory, bytes);
+        }
+    }
+    set_huge_pages(false);
+}
+
+// Test a vector that grows past the size of a huge page
+void test_huge_page_allocator(void) {
+    set_huge_pages(true);
+    std::vector<int, HugePageAllocator<int>> values;
+    for (int i = 0; i < (int)(HUGE_PAGE_SIZE / sizeof(int)) + 10; i++) values.push_back(i);
+    TEST_CHECK(values[12345] == 12345 && values.back() == (int)values.size() - 1);
+    set_huge_pages(false);
+}
+
+// Test that vectors read on huge pages have the same values
+void test_vectors_huge_pages(void) {
+    const char *file_name = "huge_pages_test.bin";
+    const int dimension = 4, count = 50;
+    std::ofstream file(file_name, std::ios::binary);
+    uint32_t num = count;
+    file.write(reinterpret_cast<char*>(&num), sizeof(num));
+    for (int i = 0; i < count; i++) {
+        float record[2 + dimension] = {(float)(i % 3), (float)i, (float)i, (float)-i, 0.5f, (float)(2 * i)};
+        file.write(reinterpret_cast<char*>(record), sizeof(record));
+    }
+    file.close();
+
+    Vectors normal(file_name, dimension, count, 0);
+    set_huge_pages(true);
+    Vectors huge(file_name, dimension, count, 0);
+    set_huge_pages(false);
+
+    TEST_CHECK(huge.size() == count);
+    for (int i = 0; i < count; i++) {
+        TEST_CHECK(std::equal(huge[i], huge[i] + dimension, normal[i]));
+        // Base vectors are stored back to back
+        if (i > 0) TEST_CHECK(huge[i] == huge[i - 1] + dimension);
+    }
+    std::remove(file_name);
+}
+
+// Test that the TLB miss counter reports misses only if it is available
+void test_tlb_miss_counter(void) {
+    TlbMissCounter counter;
+    std::vector<char> buffer(HUGE_PAGE_SIZE);
+    for (size_t i = 0; i < buffer.size(); i += 4096) buffer[i]++;
+    TEST_CHECK(counter.available() ? counter.read() >= 0 : counter.read() == -1);
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_huge_alloc", test_huge_alloc },
+    { "test_huge_page_allocator", test_huge_page_allocator },
+    { "test_vectors_huge_pages", test_vectors_huge_pages },
+    { "test_tlb_miss_counter", test_tlb_miss_counter },
+    { NULL, NULL }
+};
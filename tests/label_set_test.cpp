@@ -0,0 +1,75 @@
+#include "acutest.h"               // Acutest testing framework
+#include "label_set.hpp"           // LabelSet class
+
+#include <vector>
+
+// Test for inserting labels and reading them back
+void test_label_set_insert(void) {
+    LabelSet set;
+    TEST_CHECK(set.empty());
+    TEST_CHECK(set.size() == 0);
+
+    set.insert(40);
+    set.insert(3);
+    set.insert(40);
+    TEST_CHECK(!set.empty());
+    TEST_CHECK(set.size() == 2);
+    TEST_CHECK(set.contains(3) && set.contains(40));
+    TEST_CHECK(!set.contains(4) && !set.contains(100));
+    TEST_CHECK((set.labels() == std::vector<Label>{3, 40}));
+}
+
+// Test for sets holding labels that do not fit in a bitmap
+void test_label_set_large_labels(void) {
+    LabelSet set{5, 31};
+    set.insert(LABEL_BITMAP_BITS + 10);
+    set.insert(UNKNOWN_LABEL);
+    set.insert(LABEL_BITMAP_BITS + 10);
+
+    TEST_CHECK(set.size() == 4);
+    TEST_CHECK(set.contains(5) && set.contains(31) && set.contains(UNKNOWN_LABEL));
+    TEST_CHECK(!set.contains(6));
+    TEST_CHECK((set.labels() == std::vector<Label>{5, 31, LABEL_BITMAP_BITS + 10, UNKNOWN_LABEL}));
+}
+
+// Test for intersection and subset predicates, for every combination of bitmaps and arrays
+void test_label_set_predicates(void) {
+    for (Label offset : {0u, (Label)LABEL_BITMAP_BITS}) {
+        LabelSet a{1, 2, 70}, b{2, 3}, c{4}, d{1, 2, 3, 70};
+        a.insert(offset);
+        d.insert(offset);
+
+        TEST_CHECK(a.intersects(b) && b.intersects(a));
+        TEST_CHECK(!a.intersects(c) && !c.intersects(b));
+        TEST_CHECK(!a.intersects(LabelSet()));
+
+        TEST_CHECK(a.subset_of(d) && b.subset_of(d));
+        TEST_CHECK(!d.subset_of(a) && !c.subset_of(d));
+        TEST_CHECK(LabelSet().subset_of(c));
+
+        // a ∩ b = {2}
+        TEST_CHECK(a.common_subset_of(b, LabelSet{2}));
+        TEST_CHECK(a.common_subset_of(b, d));
+        TEST_CHECK(!a.common_subset_of(b, c));
+        // a ∩ c is empty, so it is a subset of every set
+        TEST_CHECK(a.common_subset_of(c, LabelSet()));
+    }
+
+    // Two arrays, with common labels past the bitmap and a query label that no point has
+    Label large = LABEL_BITMAP_BITS;
+    LabelSet e{1, large, large + 5}, f{2, large + 5, large + 9}, unknown(UNKNOWN_LABEL);
+    TEST_CHECK(e.intersects(f) && f.intersects(e));
+    TEST_CHECK(!e.intersects(unknown) && !unknown.intersects(LabelSet{1, 2}));
+    TEST_CHECK(!e.subset_of(f) && LabelSet{large + 5}.subset_of(f));
+    TEST_CHECK(e.common_subset_of(f, LabelSet{large + 5}) && !e.common_subset_of(f, LabelSet{large}));
+    LabelSet g{1, 2};
+    TEST_CHECK(g.common_subset_of(e, LabelSet{1}) && !g.common_subset_of(e, LabelSet{2}));
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_label_set_insert", test_label_set_insert },
+    { "test_label_set_large_labels", test_label_set_large_labels },
+    { "test_label_set_predicates", test_label_set_predicates },
+    { NULL, NULL }
+};
@@ -0,0 +1,54 @@
+#include "acutest.h"               // Acutest testing framework
+#include "latency.hpp"             // LatencyHistogram class
+
+// Test for percentiles of small latencies, which are recorded exactly
+void test_latency_small(void) {
+    LatencyHistogram histogram;
+    TEST_CHECK(histogram.count() == 0);
+    TEST_CHECK(histogram.percentile(50) == 0);
+
+    for (int i = 1; i <= 10; i++) histogram.record(i);
+
+    TEST_CHECK(histogram.count() == 10);
+    TEST_CHECK(histogram.max() == 10);
+    TEST_CHECK(histogram.mean() == 5.5);
+    TEST_CHECK(histogram.percentile(0) == 1);
+    TEST_CHECK(histogram.percentile(50) == 5);
+    TEST_CHECK(histogram.percentile(90) == 9);
+    TEST_CHECK(histogram.percentile(99.9) == 10);
+    TEST_CHECK(histogram.percentile(100) == 10);
+}
+
+// Test that large latencies are recorded within the relative error of their bucket
+void test_latency_large(void) {
+    LatencyHistogram histogram;
+    for (long i = 1; i <= 1000; i++) histogram.record(i * 1000);
+
+    long p50 = histogram.percentile(50), p99 = histogram.percentile(99);
+    TEST_CHECK(p50 >= 500000 && p50 <= 500000 + 500000 / 32);
+    TEST_CHECK(p99 >= 990000 && p99 <= 990000 + 990000 / 32);
+    TEST_CHECK(histogram.percentile(100) == 1000000);
+    TEST_MSG("p50 = %ld, p99 = %ld", p50, p99);
+}
+
+// Test for merging the histograms of different threads
+void test_latency_merge(void) {
+    LatencyHistogram a, b;
+    for (int i = 0; i < 90; i++) a.record(10);
+    for (int i = 0; i < 10; i++) b.record(20000);
+
+    a.merge(b);
+    TEST_CHECK(a.count() == 100);
+    TEST_CHECK(a.max() == 20000);
+    TEST_CHECK(a.mean() == 2009);
+    TEST_CHECK(a.percentile(90) == 10);
+    TEST_CHECK(a.percentile(91) == 20000);
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_latency_small", test_latency_small },
+    { "test_latency_large", test_latency_large },
+    { "test_latency_merge", test_latency_merge },
+    { NULL, NULL }
+};
@@ -0,0 +1,38 @@
+#include "acutest.h"               // Acutest testing framework
+#include "numa_placement.hpp"      // NUMA topology and placement
+
+#include <vector>
+
+// Test for lists of CPUs and nodes in the format of sysfs
+void test_parse_cpu_list(void) {
+    TEST_CHECK((parse_cpu_list("0") == std::vector<int>{0}));
+    TEST_CHECK((parse_cpu_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    TEST_CHECK((parse_cpu_list("4-5,0") == std::vector<int>{0, 4, 5}));
+    TEST_CHECK(parse_cpu_list("").empty());
+}
+
+// Test that consecutive threads are assigned to different nodes
+void test_spread_cpus(void) {
+    TEST_CHECK((spread_cpus({{0, 1, 2}, {4, 5}}) == std::vector<int>{0, 4, 1, 5, 2}));
+    TEST_CHECK((spread_cpus({{0, 1}}) == std::vector<int>{0, 1}));
+    TEST_CHECK(spread_cpus({}).empty());
+}
+
+// Test that the topology of the machine has at least one node with CPUs
+void test_numa_node_cpus(void) {
+    std::vector<std::vector<int>> node_cpus = numa_node_cpus();
+    TEST_CHECK(!node_cpus.empty());
+    for (const auto& cpus : node_cpus) TEST_CHECK(!cpus.empty());
+
+    // Every thread is pinned, and interleaving is only reported as set on more than one node
+    TEST_CHECK(pin_threads() > 0);
+    if (node_cpus.size() == 1) TEST_CHECK(!interleave_memory(true));
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_parse_cpu_list", test_parse_cpu_list },
+    { "test_spread_cpus", test_spread_cpus },
+    { "test_numa_node_cpus", test_numa_node_cpus },
+    { NULL, NULL }
+};
@@ -0,0 +1,89 @@
+#include "acutest.h"
+#include "query_planner.hpp"
+
+#include <vector>
+
+#define NUM_OF_ENTRIES 100
+
+// Vectors lie on a line in ascending order and even (odd) vectors have label 0 (1). The query is a copy of vector 50
+static void init_query(Vectors& vectors, const LabelSet& filter) {
+    float query_values[] = {151, 152, 153};
+    vectors.add_query(query_values);
+    vectors.filters[NUM_OF_ENTRIES] = filter;
+}
+
+// Test for the choice of plan from the number of points of the query's labels
+void test_plan_filtered_query(void) {
+    Vectors vectors(NUM_OF_ENTRIES, 1);
+    init_query(vectors, LabelSet(0));   // 50 points
+
+    TEST_CHECK(plan_filtered_query(vectors, NUM_OF_ENTRIES, 50, 100) == PLAN_BRUTE_FORCE);
+    TEST_CHECK(plan_filtered_query(vectors, NUM_OF_ENTRIES, 49, 50) == PLAN_GRAPH_LARGE_L);
+    TEST_CHECK(plan_filtered_query(vectors, NUM_OF_ENTRIES, 10, 20) == PLAN_GRAPH);
+
+    // Points of every label of the query are counted
+    vectors.filters[NUM_OF_ENTRIES] = LabelSet{0, 1};
+    TEST_CHECK(plan_filtered_query(vectors, NUM_OF_ENTRIES, 99, 100) == PLAN_GRAPH_LARGE_L);
+}
+
+// Test for the exhaustive search of the posting lists
+void test_filtered_brute_force(void) {
+    Vectors vectors(NUM_OF_ENTRIES, 1);
+    init_query(vectors, LabelSet(1));
+    DirectedGraph graph(NUM_OF_ENTRIES);
+
+    auto result = FilteredBruteForce(graph, vectors, NUM_OF_ENTRIES, 3);
+    // Ties are broken by index
+    TEST_CHECK((result == std::vector<int>{49, 51, 47}));
+
+    // Deleted points are never returned
+    graph.mark_deleted(49);
+    graph.mark_deleted(51);
+    result = FilteredBruteForce(graph, vectors, NUM_OF_ENTRIES, 2);
+    TEST_CHECK((result == std::vector<int>{47, 53}));
+
+    // A point with several of the query's labels is returned once
+    vectors.filters[NUM_OF_ENTRIES] = LabelSet{0, 1};
+    vectors.add_filter(50, 1);
+    result = FilteredBruteForce(graph, vectors, NUM_OF_ENTRIES, NUM_OF_ENTRIES);
+    TEST_CHECK(result.size() == NUM_OF_ENTRIES - 2);
+    TEST_CHECK(result[0] == 50);
+}
+
+// Test that every plan finds the neighbors of the query
+void test_filtered_search(void) {
+    Vectors vectors(NUM_OF_ENTRIES, 1);
+    init_query(vectors, LabelSet(0));
+
+    // Each even vector is linked to its previous and next even vector
+    DirectedGraph graph(NUM_OF_ENTRIES);
+    for (int i = 0; i < NUM_OF_ENTRIES - 2; i += 2) {
+        graph.insert(i, i + 2);
+        graph.insert(i + 2, i);
+    }
+
+    for (QueryPlan plan : {PLAN_BRUTE_FORCE, PLAN_GRAPH_LARGE_L, PLAN_GRAPH}) {
+        auto result = FilteredSearch(graph, vectors, {0}, NUM_OF_ENTRIES, 3, 5, plan, 2);
+        TEST_CHECK((result == std::vector<int>{50, 48, 52}));
+    }
+}
+
+// Test for the choice of the start node candidate of every label closest to the query
+void test_closest_start_nodes(void) {
+    Vectors vectors(NUM_OF_ENTRIES, 1);
+    init_query(vectors, LabelSet(1));
+    std::vector<std::vector<int>> start_points = {{0, 40, 90}, {1, 61, 99}, {}};
+
+    TEST_CHECK((closest_start_nodes(LabelSet(1), start_points, vectors, NUM_OF_ENTRIES) == std::vector<int>{61}));
+    // Unfiltered queries get the closest candidate of every label. Labels without points are ignored
+    TEST_CHECK((closest_start_nodes(LabelSet(), start_points, vectors, NUM_OF_ENTRIES) == std::vector<int>{40, 61}));
+    TEST_CHECK(closest_start_nodes(LabelSet(2), start_points, vectors, NUM_OF_ENTRIES).empty());
+}
+
+TEST_LIST = {
+    { "test_plan_filtered_query", test_plan_filtered_query },
+    { "test_filtered_brute_force", test_filtered_brute_force },
+    { "test_filtered_search", test_filtered_search },
+    { "test_closest_start_nodes", test_closest_start_nodes },
+    { NULL, NULL }
+};
@@ -0,0 +1,61 @@
+#include "acutest.h"               // Acutest testing framework
+#include "query_stream.hpp"        // QueryStream class
+#include "vectors.hpp"             // Vectors class for data management
+
+#include <cstring>
+
+// Check that streaming 'read_num' queries in chunks of 'chunk_size' loads the same queries, in the same order, as
+// reading them all at once
+static void check_stream(int read_num, int chunk_size, bool range_queries) {
+    Vectors all("dummy/dummy-data.bin", 100, 100, read_num);
+    all.read_queries("dummy/dummy-queries.bin", read_num, range_queries);
+    Vectors chunk("dummy/dummy-data.bin", 100, 100, chunk_size);
+    QueryStream stream("dummy/dummy-queries.bin", 100, read_num, chunk_size, range_queries);
+
+    int total = 0, loaded;
+    while ((loaded = stream.next(chunk)) > 0) {
+        TEST_CHECK(loaded <= chunk_size);
+        TEST_CHECK(stream.first() == total);
+        for (int i = 0; i < loaded; i++) {
+            int query = 100 + i, expected = 100 + total + i;
+            TEST_CHECK(std::memcmp(chunk[query], all[expected], 100 * sizeof(float)) == 0);
+            TEST_CHECK(chunk.filters[query].labels() == all.filters[expected].labels());
+            TEST_CHECK(chunk.query_range(query).from == all.query_range(expected).from);
+            TEST_CHECK(chunk.query_range(query).to == all.query_range(expected).to);
+        }
+        total += loaded;
+    }
+    TEST_CHECK(total == read_num);
+}
+
+// Test for streaming queries without timestamp queries, which are skipped
+void test_query_stream_chunks(void) {
+    check_stream(1000, 128, false);
+    check_stream(1000, 1000, false);
+    check_stream(999, 1, false);
+}
+
+// Test for streaming queries with timestamp queries
+void test_query_stream_ranges(void) {
+    check_stream(1000, 300, true);
+}
+
+// Test for a file with fewer queries than asked
+void test_query_stream_end(void) {
+    Vectors vectors("dummy/dummy-data.bin", 100, 100, 4096);
+    QueryStream stream("dummy/dummy-queries.bin", 100, 1000000, 4096);
+
+    int total = 0, loaded;
+    while ((loaded = stream.next(vectors)) > 0) total += loaded;
+    // Only the unfiltered and filtered queries of the 10000 are loaded
+    TEST_CHECK(total == 5012);
+    TEST_CHECK(stream.next(vectors) == 0);
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_query_stream_chunks", test_query_stream_chunks },
+    { "test_query_stream_ranges", test_query_stream_ranges },
+    { "test_query_stream_end", test_query_stream_end },
+    { NULL, NULL }
+};
@@ -0,0 +1,71 @@
+#include "acutest.h"
+#include "range_search.hpp"
+
+#include <limits>
+#include <vector>
+
+#define NUM_OF_ENTRIES 100
+
+// Vectors lie on a line in ascending order, the timestamp of vector i is i and even (odd) vectors have label 0 (1)
+// The query is a copy of vector 50, with a range of timestamps [10, 20]
+static void init_vectors(Vectors& vectors) {
+    float query_values[] = {151, 152, 153};
+    vectors.add_query(query_values);
+    vectors.ranges[0] = {10, 20};
+    vectors.build_time_index();
+}
+
+// Test for the exhaustive search of a range
+void test_range_brute_force(void) {
+    Vectors vectors(NUM_OF_ENTRIES, 1);
+    init_vectors(vectors);
+    DirectedGraph graph(NUM_OF_ENTRIES);
+
+    auto result = RangeBruteForce(graph, vectors, NUM_OF_ENTRIES, 3);
+    TEST_CHECK((result == std::vector<int>{20, 19, 18}));
+
+    // Deleted points are never returned
+    graph.mark_deleted(20);
+    result = RangeBruteForce(graph, vectors, NUM_OF_ENTRIES, 3);
+    TEST_CHECK((result == std::vector<int>{19, 18, 17}));
+
+    // Filtered queries only return points of their labels
+    vectors.filters[NUM_OF_ENTRIES] = LabelSet(0);
+    result = RangeBruteForce(graph, vectors, NUM_OF_ENTRIES, 3);
+    TEST_CHECK((result == std::vector<int>{18, 16, 14}));
+
+    // The range may have fewer than k points
+    result = RangeBruteForce(graph, vectors, NUM_OF_ENTRIES, 100);
+    TEST_CHECK(result.size() == 5);
+}
+
+// Test for the graph search of a range, where points out of the range are traversed but not returned
+void test_range_search(void) {
+    Vectors vectors(NUM_OF_ENTRIES, 1);
+    init_vectors(vectors);
+
+    // Each vector is linked to its previous and next vector
+    DirectedGraph graph(NUM_OF_ENTRIES);
+    for (int i = 0; i < NUM_OF_ENTRIES - 1; i++) {
+        graph.insert(i, i + 1);
+        graph.insert(i + 1, i);
+    }
+
+    // With a threshold of 0 the graph is searched. Starting from vector 0, it goes through the range towards vector 50
+    auto result = RangeSearch(graph, vectors, {0}, NUM_OF_ENTRIES, 3, 10, std::numeric_limits<int>::max(), 0);
+    TEST_CHECK((result == std::vector<int>{20, 19, 18}));
+
+    // With a larger threshold the range is scanned, so no start node is needed
+    result = RangeSearch(graph, vectors, {}, NUM_OF_ENTRIES, 3, 10, std::numeric_limits<int>::max(), 11);
+    TEST_CHECK((result == std::vector<int>{20, 19, 18}));
+
+    // Starting from vector 99, the search stops around vector 50 and never reaches the range
+    result = RangeSearch(graph, vectors, {99}, NUM_OF_ENTRIES, 3, 10, std::numeric_limits<int>::max(), 0);
+    TEST_CHECK(result.empty());
+}
+
+TEST_LIST = {
+    { "test_range_brute_force", test_range_brute_force },
+    { "test_range_search", test_range_search },
+    { NULL, NULL }
+};
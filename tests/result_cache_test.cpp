@@ -0,0 +1,71 @@
+#include "acutest.h"               // Acutest testing framework
+#include "result_cache.hpp"        // ResultCache class
+
+#include <vector>
+
+// Test for cached results and the hit rate
+void test_result_cache_lookup(void) {
+    ResultCache cache(100);
+    float values[] = {1.0, 2.0, 3.0};
+    std::vector<int> result;
+
+    TEST_CHECK(!cache.lookup(LabelSet{1}, values, 3, 10, 50, result));
+    cache.insert(LabelSet{1}, values, 3, 10, 50, {4, 8, 15});
+    TEST_CHECK(cache.lookup(LabelSet{1}, values, 3, 10, 50, result));
+    TEST_CHECK((result == std::vector<int>{4, 8, 15}));
+
+    // Values that differ by less than the quantization step share the results
+    float close[] = {1.0 + RESULT_CACHE_STEP / 4, 2.0, 3.0};
+    TEST_CHECK(cache.lookup(LabelSet{1}, close, 3, 10, 50, result));
+
+    TEST_CHECK(cache.hits() == 2 && cache.misses() == 1);
+    TEST_CHECK(cache.hit_rate() == 2.0 / 3);
+    TEST_CHECK(cache.size() == 1);
+}
+
+// Test that the filter, the values, k and L are all part of the key
+void test_result_cache_key(void) {
+    ResultCache cache(100);
+    float values[] = {1.0, 2.0, 3.0}, other[] = {1.0, 2.0, 3.5};
+    std::vector<int> result;
+    cache.insert(LabelSet{1}, values, 3, 10, 50, {4});
+
+    TEST_CHECK(!cache.lookup(LabelSet{2}, values, 3, 10, 50, result));
+    TEST_CHECK(!cache.lookup(LabelSet(), values, 3, 10, 50, result));
+    TEST_CHECK(!cache.lookup(LabelSet{1}, other, 3, 10, 50, result));
+    TEST_CHECK(!cache.lookup(LabelSet{1}, values, 3, 5, 50, result));
+    TEST_CHECK(!cache.lookup(LabelSet{1}, values, 3, 10, 100, result));
+    TEST_CHECK(cache.lookup(LabelSet{1}, values, 3, 10, 50, result));
+}
+
+// Test that the cache stays bounded and that referenced results survive eviction
+void test_result_cache_eviction(void) {
+    const int capacity = RESULT_CACHE_SHARDS * 4;
+    ResultCache cache(capacity);
+    std::vector<int> result;
+
+    float hot[] = {-1.0};
+    cache.insert(LabelSet(), hot, 1, 1, 1, {0});
+    for (int i = 0; i < 10 * capacity; i++) {
+        // Keep the hot query referenced, so CLOCK gives it a second chance every time the hand reaches it
+        TEST_CHECK(cache.lookup(LabelSet(), hot, 1, 1, 1, result));
+
+        float values[] = {(float)i};
+        cache.insert(LabelSet(), values, 1, 1, 1, {i});
+        TEST_CHECK(cache.size() <= (size_t)capacity);
+    }
+    TEST_CHECK(cache.evictions() > 0);
+
+    // The most recent query is still cached, the first ones are evicted
+    float last[] = {(float)(10 * capacity - 1)}, first[] = {0.0};
+    TEST_CHECK(cache.lookup(LabelSet(), last, 1, 1, 1, result) && result[0] == 10 * capacity - 1);
+    TEST_CHECK(!cache.lookup(LabelSet(), first, 1, 1, 1, result));
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_result_cache_lookup", test_result_cache_lookup },
+    { "test_result_cache_key", test_result_cache_key },
+    { "test_result_cache_eviction", test_result_cache_eviction },
+    { NULL, NULL }
+};
@@ -0,0 +1,50 @@
+#include "acutest.h"               // Acutest testing framework
+#include "stats.hpp"               // StatsCollector class
+
+// Test for the percentiles of the collected counters
+void test_stats_percentile(void) {
+    StatsCollector collector;
+    TEST_CHECK(collector.size() == 0);
+    TEST_CHECK(collector.percentile(50).distances == 0);
+
+    // Queries with 1, 2, ..., 100 distance computations and twice as many expansions
+    for (int i = 100; i >= 1; i--) {
+        collector.begin();
+        thread_stats.distances += i;
+        thread_stats.expansions += 2 * i;
+        collector.end();
+    }
+
+    TEST_CHECK(collector.size() == 100);
+    TEST_CHECK(collector.percentile(0).distances == 1);
+    TEST_CHECK(collector.percentile(50).distances == 51);
+    TEST_CHECK(collector.percentile(99).distances == 100);
+    TEST_CHECK(collector.percentile(100).distances == 100);
+    TEST_CHECK(collector.percentile(90).expansions == 182);
+    TEST_CHECK(collector.percentile(90).evictions == 0);
+    TEST_CHECK(collector.mean().distances == 50);
+    TEST_CHECK(collector.mean().expansions == 101);
+}
+
+// Test that the counters are reset for every query
+void test_stats_begin(void) {
+    StatsCollector collector;
+
+    collector.begin();
+    thread_stats.visited += 10;
+    collector.end();
+
+    collector.begin();
+    thread_stats.visited += 3;
+    collector.end();
+
+    TEST_CHECK(collector.percentile(0).visited == 3);
+    TEST_CHECK(collector.percentile(100).visited == 10);
+}
+
+// List of test functions for the test runner
+TEST_LIST = {
+    { "test_stats_percentile", test_stats_percentile },
+    { "test_stats_begin", test_stats_begin },
+    { NULL, NULL }
+};
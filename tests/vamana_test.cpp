@@ -109,10 +109,34 @@ void test_read_and_write_file(void) {
     delete g2;
 }
 
+void test_read_and_write_file_with_deletions(void) {
+    // Deleted vertices must survive a write/read round trip
+    DirectedGraph *g1 = random_graph(NUM_OF_ENTRIES, R);
+    g1->mark_deleted(1);
+    g1->mark_deleted(2);
+    g1->free_tombstones();
+    g1->mark_deleted(3);
+
+    const std::string file_name = "build/test_vamana_file_deletions";
+    write_vamana_to_file(*g1, file_name);
+    DirectedGraph *g2 = read_vamana_from_file(file_name);
+
+    TEST_CHECK(g2->get_size() == NUM_OF_ENTRIES);
+    TEST_CHECK(g2->get_free_vertices().size() == 2);
+    TEST_CHECK(g2->get_tombstones().size() == 1 && g2->get_tombstones()[0] == 3);
+    TEST_CHECK(g2->is_deleted(1) && g2->is_deleted(2) && g2->is_deleted(3) && !g2->is_deleted(4));
+    TEST_CHECK(g2->get_neighbors(1).empty());
+    TEST_CHECK(g2->get_neighbors(3).size() == g1->get_neighbors(3).size());
+
+    delete g1;
+    delete g2;
+}
+
 TEST_LIST = {
     { "test_random_graph", test_random_graph },
     { "test_medoid", test_medoid },
     { "test_vamana", test_vamana },
     { "test_read_and_write_file", test_read_and_write_file },
+    { "test_read_and_write_file_with_deletions", test_read_and_write_file_with_deletions },
     { NULL, NULL }
 };
\ No newline at end of file
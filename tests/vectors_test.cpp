@@ -6,6 +6,8 @@
 #include <memory>
 #include <iostream>
 #include <iomanip> 
+#include <cmath>
+#include <limits>
 
 // Test for Vectors constructor 
 void test_vectors_constructor(void) {
@@ -143,6 +145,14 @@ void test_vectors_same_filter(void) {
     TEST_CHECK(vectors.same_filter(2, 4)); 
 
     TEST_CHECK(vectors.same_filter(15, 23)); 
+
+    TEST_CHECK(!vectors.same_filter(2, 3)); 
+
+    // A point with multiple labels shares a filter with the points of each one of them
+    vectors.add_filter(2, 1);
+    TEST_CHECK(vectors.same_filter(2, 3)); 
+    TEST_CHECK(vectors.same_filter(2, 4)); 
+    TEST_CHECK(vectors.postings[1][1] == 2);
 }
 
 // Test for Vectors' Euclidean distance function
@@ -153,6 +163,171 @@ void test_vectors_euclidean_distance(void) {
     TEST_CHECK(vectors.euclidean_distance(0, 1) == 27); 
 }
 
+// Test for the Euclidean distance that is abandoned once it exceeds a bound
+void test_vectors_bounded_distance(void) {
+    Vectors vectors("dummy/dummy-data.bin", 100, 100, 0);
+
+    for (int i = 1; i < 100; i++) {
+        float distance = vectors.euclidean_distance(0, i);
+
+        // Distances up to the bound are exact
+        TEST_CHECK(vectors.euclidean_distance(0, i, std::numeric_limits<float>::max()) == distance);
+        TEST_CHECK(vectors.euclidean_distance(0, i, distance) == distance);
+
+        // Else a partial sum that exceeds the bound is returned
+        float partial = vectors.euclidean_distance(0, i, distance / 4);
+        TEST_CHECK(partial > distance / 4 && partial <= distance * 1.0001f);
+    }
+}
+
+// Test that the PCA rotation keeps the distances and sorts the dimensions by descending variance
+void test_vectors_pca_rotate(void) {
+    Vectors original("dummy/dummy-data.bin", 100, 500, 1), rotated("dummy/dummy-data.bin", 100, 500, 1);
+    rotated.pca_rotate();
+
+    // Queries are rotated when they are added after the rotation
+    original.read_queries("dummy/dummy-queries.bin", 1);
+    rotated.read_queries("dummy/dummy-queries.bin", 1);
+
+    for (int i = 1; i <= 500; i++) {
+        float distance = original.euclidean_distance(0, i), rotated_distance = rotated.euclidean_distance(0, i);
+        TEST_CHECK(std::fabs(distance - rotated_distance) <= 1e-3 * distance + 1e-3);
+    }
+
+    std::vector<double> variance(100, 0.0), mean(100, 0.0);
+    for (int i = 0; i < 500; i++)
+        for (int j = 0; j < 100; j++) mean[j] += rotated[i][j] / 500;
+    for (int i = 0; i < 500; i++)
+        for (int j = 0; j < 100; j++) variance[j] += (rotated[i][j] - mean[j]) * (rotated[i][j] - mean[j]) / 500;
+    for (int j = 1; j < 100; j++) TEST_CHECK(variance[j] <= variance[j - 1] * 1.001 + 1e-6);
+    TEST_CHECK(variance[0] > 10 * variance[99]);
+}
+
+// Test for appending base vectors after queries have been added
+void test_vectors_add_vector(void) {
+    Vectors vectors(100, 1);
+
+    float query_values[] = {1.0, 1.0, 1.0};
+    vectors.add_query(query_values);
+
+    float values[] = {5.0, 6.0, 7.0};
+    int index = vectors.add_vector(values, 7);
+
+    // The new vector is appended right after the old base vectors
+    TEST_CHECK(index == 100);
+    TEST_CHECK(vectors.size() == 101);
+    TEST_CHECK(vectors[100][0] == 5.0 && vectors[100][1] == 6.0 && vectors[100][2] == 7.0);
+    TEST_CHECK(vectors.filters[100].size() == 1);
+    Label label = vectors.filters[100].labels()[0];
+    TEST_CHECK(vectors.label_values[label] == 7);
+    TEST_CHECK(vectors.postings[label].size() == 1 && vectors.postings[label][0] == 100);
+
+    // The query must still follow the base vectors
+    TEST_CHECK(vectors[101][0] == 1.0 && vectors[101][1] == 1.0 && vectors[101][2] == 1.0);
+
+    // Old vectors must be untouched
+    TEST_CHECK(vectors.euclidean_distance(0, 1) == 27);
+}
+
+// Test for appending the base vectors of another Vectors object
+void test_vectors_append_vectors(void) {
+    Vectors vectors("dummy/dummy-data.bin", 100, 50, 0);
+    Vectors other("dummy/dummy-data.bin", 100, 60, 0);
+    int appended = vectors.append_vectors(other, 10);
+
+    TEST_CHECK(appended == 50);
+    TEST_CHECK(vectors.size() == 100);
+
+    // Vector i + 50 is a copy of the (i + 10)-th vector of the file
+    for (int i = 0; i < 50; i++) {
+        TEST_CHECK(std::memcmp(vectors[i + 50], other[i + 10], 100 * sizeof(float)) == 0);
+        Label label = vectors.filters[i + 50].labels()[0], other_label = other.filters[i + 10].labels()[0];
+        TEST_CHECK(vectors.label_values[label] == other.label_values[other_label]);
+    }
+}
+
+// Test for the mapping of filter values to dense label ids
+void test_vectors_labels(void) {
+    Vectors vectors(10, 0);
+
+    // Filter values are numbered in order of appearance
+    TEST_CHECK(vectors.num_labels() == 2);
+    TEST_CHECK(vectors.find_label(0) == 0 && vectors.find_label(1) == 1);
+    TEST_CHECK(vectors.find_label(-1) == NO_LABEL);
+    TEST_CHECK(vectors.find_label(42) == UNKNOWN_LABEL);
+
+    // Posting lists are sorted and hold every point of the label
+    TEST_CHECK((vectors.postings[1] == std::vector<int>{1, 3, 5, 7, 9}));
+
+    vectors.remove_posting(5);
+    TEST_CHECK((vectors.postings[1] == std::vector<int>{1, 3, 7, 9}));
+
+    Label label = vectors.add_label(42);
+    TEST_CHECK(label == 2 && vectors.num_labels() == 3 && vectors.postings[label].empty());
+    TEST_CHECK(vectors.add_label(42) == label);
+}
+
+// Test for loading extra labels of the base vectors
+void test_vectors_read_labels(void) {
+    Vectors vectors(10, 0);
+
+    // Vector 0 gets labels 1 and 5, vector 1 gets no extra labels and vector 2 gets label 5
+    const char *file_name = "labels_test.bin";
+    {
+        std::ofstream file(file_name, std::ios::binary);
+        u_int32_t num_vectors = 3, counts[] = {2, 0, 1};
+        float labels_0[] = {1, 5}, labels_2[] = {5};
+        file.write(reinterpret_cast<char*>(&num_vectors), sizeof(num_vectors));
+        file.write(reinterpret_cast<char*>(&counts[0]), sizeof(u_int32_t));
+        file.write(reinterpret_cast<char*>(labels_0), sizeof(labels_0));
+        file.write(reinterpret_cast<char*>(&counts[1]), sizeof(u_int32_t));
+        file.write(reinterpret_cast<char*>(&counts[2]), sizeof(u_int32_t));
+        file.write(reinterpret_cast<char*>(labels_2), sizeof(labels_2));
+    }
+    vectors.read_labels(file_name);
+    std::remove(file_name);
+
+    Label label_5 = vectors.find_label(5);
+    TEST_CHECK(vectors.num_labels() == 3);
+    TEST_CHECK((vectors.filters[0] == LabelSet{0, 1, label_5}));
+    TEST_CHECK((vectors.filters[1] == LabelSet{1}));
+    TEST_CHECK((vectors.filters[2] == LabelSet{0, label_5}));
+    TEST_CHECK((vectors.postings[1] == std::vector<int>{0, 1, 3, 5, 7, 9}));
+    TEST_CHECK((vectors.postings[label_5] == std::vector<int>{0, 2}));
+}
+
+// Test for loading timestamps and timestamp queries
+void test_vectors_read_range_queries(void) {
+    Vectors vectors("dummy/dummy-data.bin", 100, 100, 8);
+    vectors.read_queries("dummy/dummy-queries.bin", 8, true);
+
+    TEST_CHECK(std::abs(vectors.timestamps[0] - 0.0238129) < 1e-5);
+
+    // The first 4 queries are of types 0, 1, 2 and 3
+    TEST_CHECK(vectors.filters[100].empty() && !vectors.query_range(100).bounded());
+    TEST_CHECK(!vectors.filters[101].empty() && !vectors.query_range(101).bounded());
+    TEST_CHECK(vectors.filters[102].empty() && vectors.query_range(102).bounded());
+    TEST_CHECK(!vectors.filters[103].empty() && vectors.query_range(103).bounded());
+    TEST_CHECK(std::abs(vectors.query_range(102).from - 0.37232) < 1e-5);
+    TEST_CHECK(std::abs(vectors.query_range(102).to - 0.934754) < 1e-5);
+}
+
+// Test for the timestamp index
+void test_vectors_time_index(void) {
+    Vectors vectors(10, 0);     // Timestamp of vector i is i
+    vectors.timestamps[3] = 7.5;
+    vectors.build_time_index();
+
+    TEST_CHECK((vectors.time_index == std::vector<int>{0, 1, 2, 4, 5, 6, 7, 3, 8, 9}));
+
+    auto bounds = vectors.time_index_bounds({2, 7.5});
+    TEST_CHECK(bounds.first == 2 && bounds.second == 8);
+    bounds = vectors.time_index_bounds({10, 20});
+    TEST_CHECK(bounds.first == bounds.second);
+    bounds = vectors.time_index_bounds(TimeRange());
+    TEST_CHECK(bounds.first == 0 && bounds.second == 10);
+}
+
 // List of test functions for the test runner
 TEST_LIST = {
     { "test_vectors_constructor", test_vectors_constructor },
@@ -163,5 +338,13 @@ TEST_LIST = {
     { "test_vectors_query_solutions", test_vectors_query_solutions},
     { "test_vectors_same_filter", test_vectors_same_filter},
     { "test_vectors_euclidean_distance", test_vectors_euclidean_distance },
+    { "test_vectors_bounded_distance", test_vectors_bounded_distance },
+    { "test_vectors_pca_rotate", test_vectors_pca_rotate },
+    { "test_vectors_add_vector", test_vectors_add_vector },
+    { "test_vectors_append_vectors", test_vectors_append_vectors },
+    { "test_vectors_labels", test_vectors_labels },
+    { "test_vectors_read_labels", test_vectors_read_labels },
+    { "test_vectors_read_range_queries", test_vectors_read_range_queries },
+    { "test_vectors_time_index", test_vectors_time_index },
     { NULL, NULL } 
 };
\ No newline at end of file